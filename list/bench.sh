@@ -0,0 +1,6 @@
+#!/bin/bash
+
+set -e
+
+g++ -std=c++17 -O2 -pthread -Wall -Wextra -I./ bench/bench.cpp -o list_bench
+./list_bench "$@"
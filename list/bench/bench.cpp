@@ -0,0 +1,846 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <memory_resource>
+#include <mutex>
+#include <unordered_map>
+#include <new>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/list.h"
+#include "src/unrolled_list.h"
+#include "src/intrusive_list.h"
+#include "src/xor_list.h"
+#include "src/lru_cache.h"
+#include "src/mpsc_list_queue.h"
+#include "src/persistent_list.h"
+#include "src/counting_allocator.h"
+#include "src/forward_list.h"
+#include "src/small_list.h"
+#include "bench/counting_new.h"
+
+
+struct Measurement {
+    double ms; // время выполнения
+    size_t allocs; // количество выделений памяти
+};
+
+template <class F>
+Measurement Measure(F&& f) {
+    size_t allocs_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return {std::chrono::duration<double, std::milli>(finish - start).count(), allocations - allocs_before};
+}
+
+void Report(const std::string& name, size_t n, Measurement task_m, Measurement std_m) {
+    std::cout << std::left << std::setw(28) << name << " n=" << std::setw(10) << n
+              << std::right << std::fixed << std::setprecision(2)
+              << " task: " << std::setw(10) << task_m.ms << " ms " << std::setw(10) << task_m.allocs << " allocs"
+              << " | std: " << std::setw(10) << std_m.ms << " ms " << std::setw(10) << std_m.allocs << " allocs"
+              << std::endl;
+}
+
+
+template <class List>
+void FillRandom(List& list, size_t n, unsigned seed) {
+    std::mt19937_64 rand(seed);
+    for (size_t i = 0; i < n; ++i) {
+        list.push_back(rand());
+    }
+}
+
+template <class List>
+Measurement MeasureEmpty(size_t n) {
+    volatile size_t sink = 0;
+    return Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            List list;
+            List moved(std::move(list));
+            sink = sink + moved.size();
+        }
+    });
+}
+
+void BenchEmpty(size_t n) {
+    Report("construct+move/empty", n, MeasureEmpty<task::list<size_t>>(n), MeasureEmpty<std::list<size_t>>(n));
+}
+
+void BenchEmplace(size_t n) {
+    // MoveTester-подобный тип: строка, которую дорого перемещать по сравнению с int
+    using Value = std::pair<size_t, std::string>;
+    const std::string payload(32, 'x');
+
+    task::list<Value> list_task, list_push;
+    std::list<Value> list_std;
+    Measurement task_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_task.emplace_back(i, payload);
+        }
+    });
+    Measurement push_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_push.push_back(Value(i, payload));
+        }
+    });
+    Measurement std_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_std.emplace_back(i, payload);
+        }
+    });
+    Report("emplace_back", n, task_m, std_m);
+    Report("push_back(T&&)", n, push_m, std_m);
+}
+
+template <class List>
+Measurement MeasureInsertRange(const std::vector<size_t>& values) {
+    List list(4, 0);
+    return Measure([&] { list.insert(std::next(list.begin(), 2), values.begin(), values.end()); });
+}
+
+void BenchInsertRange(size_t n) {
+    std::vector<size_t> values(n, 1);
+    Report("insert(pos, first, last)", n,
+           MeasureInsertRange<task::list<size_t>>(values), MeasureInsertRange<std::list<size_t>>(values));
+
+    task::list<size_t> list_task(n, 1);
+    std::list<size_t> list_std(n, 1);
+    Measurement task_m = Measure([&] { task::list<size_t> copy(list_task); });
+    Measurement std_m = Measure([&] { std::list<size_t> copy(list_std); });
+    Report("copy construct", n, task_m, std_m);
+}
+
+template <class List>
+Measurement MeasureEraseRange(size_t n) {
+    List list(n, 1);
+    auto first = std::next(list.begin(), n / 4);
+    auto last = std::next(first, n / 2);
+    return Measure([&] { list.erase(first, last); });
+}
+
+template <class List, class Value>
+Measurement MeasureClear(size_t n, const Value& value) {
+    List list(n, value);
+    return Measure([&] { list.clear(); });
+}
+
+void BenchErase(size_t n) {
+    Report("erase(first, last)", n / 2,
+           MeasureEraseRange<task::list<size_t>>(n), MeasureEraseRange<std::list<size_t>>(n));
+    Report("clear", n, MeasureClear<task::list<size_t>>(n, 1), MeasureClear<std::list<size_t>>(n, 1));
+    const std::string payload(32, 'x');
+    Report("clear/string", n, MeasureClear<task::list<std::string>>(n, payload),
+           MeasureClear<std::list<std::string>>(n, payload));
+}
+
+template <class List>
+Measurement MeasureRemove(size_t n) {
+    List list;
+    FillRandom(list, n, 42);
+    // примерно 30% элементов удаляются
+    return Measure([&] { list.remove_if([](size_t x) { return x % 10 < 3; }); });
+}
+
+template <class List>
+Measurement MeasureUnique(size_t n) {
+    List list;
+    std::mt19937_64 rand(42);
+    for (size_t i = 0; i < n; ++i) {
+        list.push_back(rand() % 4);
+    }
+    return Measure([&] { list.unique(); });
+}
+
+void BenchRemove(size_t n) {
+    Report("remove_if/30%", n, MeasureRemove<task::list<size_t>>(n), MeasureRemove<std::list<size_t>>(n));
+    Report("unique", n, MeasureUnique<task::list<size_t>>(n), MeasureUnique<std::list<size_t>>(n));
+}
+
+template <class List>
+Measurement MeasureCopyAssign(size_t n) {
+    // списки похожего размера присваиваются друг другу много раз
+    List source(n, 1), target(n - n / 10, 2);
+    return Measure([&] {
+        for (int i = 0; i < 10; ++i) {
+            target = source;
+            source.pop_back();
+        }
+    });
+}
+
+void BenchCopyAssign(size_t n) {
+    Report("copy assign x10", n, MeasureCopyAssign<task::list<size_t>>(n), MeasureCopyAssign<std::list<size_t>>(n));
+}
+
+template <class List>
+void FillPattern(List& list, size_t n, const std::string& pattern) {
+    std::mt19937_64 rand(42);
+    for (size_t i = 0; i < n; ++i) {
+        if (pattern == "sorted") {
+            list.push_back(i);
+        } else if (pattern == "reversed") {
+            list.push_back(n - i);
+        } else if (pattern == "few-inversions") {
+            list.push_back(rand() % 100 == 0 ? rand() % n : i);
+        } else {
+            list.push_back(rand());
+        }
+    }
+}
+
+void BenchSort(size_t n) {
+    for (const std::string pattern : {"sorted", "reversed", "few-inversions", "random"}) {
+        task::list<size_t> list_task, list_adaptive;
+        std::list<size_t> list_std;
+        FillPattern(list_task, n, pattern);
+        FillPattern(list_adaptive, n, pattern);
+        FillPattern(list_std, n, pattern);
+
+        Measurement std_m = Measure([&] { list_std.sort(); });
+        Report("sort/" + pattern, n, Measure([&] { list_task.sort(); }), std_m);
+        Report("adaptive_sort/" + pattern, n, Measure([&] { list_adaptive.adaptive_sort(); }), std_m);
+    }
+
+    for (unsigned bits : {16, 32, 64}) {
+        task::list<size_t> list_task, list_radix;
+        std::list<size_t> list_std;
+        std::mt19937_64 rand(42);
+        for (size_t i = 0; i < n; ++i) {
+            size_t value = rand() >> (64 - bits);
+            list_task.push_back(value);
+            list_radix.push_back(value);
+            list_std.push_back(value);
+        }
+        Measurement std_m = Measure([&] { list_std.sort(); });
+        std::string suffix = "/random" + std::to_string(bits);
+        Report("sort" + suffix, n, Measure([&] { list_task.sort(); }), std_m);
+        Report("radix_sort" + suffix, n, Measure([&] { list_radix.radix_sort(); }), std_m);
+    }
+}
+
+
+void BenchParallelSort(size_t n) {
+    task::list<size_t> list_task;
+    std::list<size_t> list_std;
+    FillRandom(list_std, n, 42);
+    Measurement std_m = Measure([&] { list_std.sort(); });
+
+    size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 8);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        list_task.clear();
+        FillRandom(list_task, n, 42);
+        Report("parallel_sort/" + std::to_string(threads) + "threads", n,
+               Measure([&] { list_task.parallel_sort(threads); }), std_m);
+    }
+}
+
+
+// агрегирование по большому списку: сумма квадратов и обновление всех элементов
+void BenchParallelReduce(size_t n) {
+    task::list<double> list_task;
+    std::list<double> list_std;
+    std::mt19937_64 rand(42);
+    std::uniform_real_distribution<double> dist(0, 1);
+    for (size_t i = 0; i < n; ++i) {
+        double x = dist(rand);
+        list_task.push_back(x);
+        list_std.push_back(x);
+    }
+    volatile double sink = 0;
+    Measurement std_reduce = Measure([&] {
+        sink = std::accumulate(list_std.begin(), list_std.end(), 0.0, [](double acc, double x) { return acc + x * x; });
+    });
+    Measurement std_for_each = Measure([&] {
+        std::for_each(list_std.begin(), list_std.end(), [](double& x) { x = x * 0.5 + 1; });
+    });
+
+    size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 8);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        Report("transform_reduce/" + std::to_string(threads) + "threads", n, Measure([&] {
+            sink = list_task.parallel_transform_reduce(0.0, std::plus<double>(), [](double x) { return x * x; }, threads);
+        }), std_reduce);
+        Report("for_each/" + std::to_string(threads) + "threads", n, Measure([&] {
+            list_task.parallel_for_each([](double& x) { x = x * 0.5 + 1; }, threads);
+        }), std_for_each);
+    }
+    // с индексом позиций начала отрезков находятся без прохода по списку
+    list_task.enable_index();
+    Report("transform_reduce/index", n, Measure([&] {
+        sink = list_task.parallel_transform_reduce(0.0, std::plus<double>(), [](double x) { return x * x; }, max_threads);
+    }), std_reduce);
+}
+
+
+template <class List>
+Measurement MeasureTraverse(const List& list) {
+    volatile size_t sink = 0;
+    return Measure([&] {
+        for (int pass = 0; pass < 10; ++pass) {
+            size_t sum = 0;
+            for (auto it = list.cbegin(); it != list.cend(); ++it) {
+                sum += *it;
+            }
+            sink = sink + sum;
+        }
+    });
+}
+
+template <class List>
+size_t FootprintBytes(List& list, size_t n) {
+    size_t bytes_before = allocated_bytes;
+    FillRandom(list, n, 42);
+    return allocated_bytes - bytes_before;
+}
+
+void BenchTraverse(size_t n) {
+    // вперемешку с другими выделениями узлы task::list и std::list разбросаны по куче,
+    // как в долго живущей программе; блоки unrolled_list сохраняют локальность внутри блока
+    task::unrolled_list<size_t> list_unrolled;
+    task::xor_list<size_t> list_xor;
+    task::list<size_t> list_task;
+    std::list<size_t> list_std;
+    std::vector<std::string> noise;
+    size_t unrolled_bytes = 0, xor_bytes = 0, task_bytes = 0, std_bytes = 0;
+    for (size_t done = 0; done < n; done += 1000) {
+        size_t step = std::min<size_t>(1000, n - done);
+        unrolled_bytes += FootprintBytes(list_unrolled, step);
+        xor_bytes += FootprintBytes(list_xor, step);
+        task_bytes += FootprintBytes(list_task, step);
+        std_bytes += FootprintBytes(list_std, step);
+        noise.emplace_back(64, 'x');
+    }
+
+    Measurement std_m = MeasureTraverse(list_std);
+    Report("traverse x10/unrolled", n, MeasureTraverse(list_unrolled), std_m);
+    Report("traverse x10/xor", n, MeasureTraverse(list_xor), std_m);
+    Report("traverse x10/list", n, MeasureTraverse(list_task), std_m);
+    std::cout << std::left << std::setw(28) << "bytes/element" << " n=" << std::setw(10) << n
+              << std::right << std::fixed << std::setprecision(2)
+              << " unrolled: " << double(unrolled_bytes) / n << " xor: " << double(xor_bytes) / n
+              << " list: " << double(task_bytes) / n
+              << " std: " << double(std_bytes) / n << std::endl;
+}
+
+
+struct Connection : task::list_hook {
+    size_t id;
+    char payload[48];
+    std::list<Connection*>::iterator std_position; // без интрузивного списка объект хранит свой узел
+};
+
+void BenchIntrusive(size_t n) {
+    // объекты уже существуют; список только связывает их и отсоединяет по ссылке на объект
+    std::vector<Connection> connections(n);
+    task::intrusive_list<Connection> list_intrusive;
+    std::list<Connection*> list_std;
+    Measurement intrusive_m = Measure([&] {
+        for (Connection& c : connections) {
+            list_intrusive.push_back(c);
+        }
+        for (size_t i = 0; i < n; i += 2) {
+            list_intrusive.erase(connections[i]);
+        }
+    });
+    Measurement std_m = Measure([&] {
+        for (Connection& c : connections) {
+            c.std_position = list_std.insert(list_std.end(), &c);
+        }
+        for (size_t i = 0; i < n; i += 2) {
+            list_std.erase(connections[i].std_position);
+        }
+    });
+    Report("intrusive link+unlink", n, intrusive_m, std_m);
+}
+
+
+// обращения к аллокатору списка по операциям: вызовы, байты и пик занятой памяти
+void BenchAllocatorCalls(size_t n) {
+    using Alloc = task::counting_allocator<std::allocator<size_t>>;
+    task::allocation_stats stats;
+    task::list<size_t, Alloc> list((Alloc(&stats)));
+    auto report = [&stats, n](const std::string& name, auto&& f) {
+        task::allocation_stats before = stats;
+        stats.peak_live_bytes = stats.live_bytes;
+        f();
+        std::cout << std::left << std::setw(28) << "allocator/" + name << " n=" << std::setw(10) << n << std::right
+                  << " allocate: " << std::setw(9) << stats.allocations - before.allocations
+                  << " deallocate: " << std::setw(9) << stats.deallocations - before.deallocations
+                  << " bytes: " << std::setw(11) << stats.bytes_allocated - before.bytes_allocated
+                  << " peak: " << std::setw(11) << stats.peak_live_bytes << std::endl;
+    };
+    report("push_back", [&] { FillRandom(list, n, 42); });
+    report("copy", [&] { task::list<size_t, Alloc> copy(list); });
+    report("sort", [&] { list.sort(); });
+    report("compact", [&] { list.compact(); });
+    report("enable_index", [&] { list.enable_index(); });
+    report("clear", [&] { list.clear(); });
+}
+
+
+void BenchCompact(size_t n) {
+    // долго живущий список после перемешивания: соседние элементы лежат в случайных местах кучи
+    task::list<size_t> list_task;
+    std::list<size_t> list_std;
+    FillRandom(list_task, n, 42);
+    FillRandom(list_std, n, 42);
+    list_task.sort();
+    list_std.sort();
+
+    Measurement std_m = MeasureTraverse(list_std);
+    double score = list_task.address_jump_score();
+    Report("traverse x10/scattered", n, MeasureTraverse(list_task), std_m);
+    Report("compact", n, Measure([&] { list_task.compact(); }), std_m);
+    Report("traverse x10/compacted", n, MeasureTraverse(list_task), std_m);
+    std::cout << std::left << std::setw(28) << "address_jump_score" << " n=" << std::setw(10) << n
+              << std::right << std::fixed << std::setprecision(2)
+              << " before: " << score << " after: " << list_task.address_jump_score() << std::endl;
+}
+
+
+void BenchIndex(size_t n) {
+    // постраничный доступ: элементы на случайных позициях
+    const size_t lookups = 200;
+    task::list<size_t> list_plain, list_indexed;
+    std::list<size_t> list_std;
+    FillRandom(list_plain, n, 42);
+    FillRandom(list_std, n, 42);
+    Measurement build_m = Measure([&] {
+        FillRandom(list_indexed, n, 42);
+        list_indexed.enable_index();
+    });
+    Measurement fill_m = Measure([&] { list_std.clear(); FillRandom(list_std, n, 42); });
+    Report("fill+enable_index", n, build_m, fill_m);
+
+    std::mt19937_64 rand(7);
+    std::vector<size_t> positions(lookups);
+    for (size_t& pos : positions) {
+        pos = rand() % n;
+    }
+    volatile size_t sink = 0;
+    Measurement std_m = Measure([&] {
+        for (size_t pos : positions) {
+            sink = sink + *std::next(list_std.begin(), pos);
+        }
+    });
+    Report("at x200/no index", n, Measure([&] {
+        for (size_t pos : positions) {
+            sink = sink + list_plain.at(pos);
+        }
+    }), std_m);
+    Report("at x200/index", n, Measure([&] {
+        for (size_t pos : positions) {
+            sink = sink + list_indexed.at(pos);
+        }
+    }), std_m);
+
+    // вставки в середину с поддержкой индекса
+    Report("insert middle x200/index", n, Measure([&] {
+        for (size_t pos : positions) {
+            list_indexed.insert(list_indexed.nth(pos), pos);
+        }
+    }), Measure([&] {
+        for (size_t pos : positions) {
+            list_std.insert(std::next(list_std.begin(), pos), pos);
+        }
+    }));
+}
+
+
+// ключи с распределением Ципфа: вероятность ключа k пропорциональна 1 / (k + 1)^s
+std::vector<size_t> ZipfKeys(size_t count, size_t universe, double s, unsigned seed) {
+    std::vector<double> cdf(universe);
+    double sum = 0;
+    for (size_t k = 0; k < universe; ++k) {
+        sum += 1.0 / std::pow(static_cast<double>(k + 1), s);
+        cdf[k] = sum;
+    }
+    std::mt19937_64 rand(seed);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<size_t> keys(count);
+    for (size_t& key : keys) {
+        key = std::lower_bound(cdf.begin(), cdf.end(), uniform(rand)) - cdf.begin();
+        key = key * 2654435761u % universe; // популярные ключи не должны идти подряд
+    }
+    return keys;
+}
+
+// обычная реализация для сравнения: std::list и std::unordered_map, узел на каждую вставку
+class StdLruCache {
+public:
+    explicit StdLruCache(size_t capacity) : capacity(capacity) {}
+    size_t* get(size_t key) {
+        auto it = index.find(key);
+        if (it == index.end()) {
+            return nullptr;
+        }
+        items.splice(items.begin(), items, it->second);
+        return &it->second->second;
+    }
+    void put(size_t key, size_t value) {
+        if (items.size() == capacity) {
+            index.erase(items.back().first);
+            items.pop_back();
+        }
+        items.emplace_front(key, value);
+        index[key] = items.begin();
+    }
+private:
+    size_t capacity;
+    std::list<std::pair<size_t, size_t>> items;
+    std::unordered_map<size_t, std::list<std::pair<size_t, size_t>>::iterator> index;
+};
+
+template <class Cache>
+Measurement MeasureLru(Cache& cache, const std::vector<size_t>& keys, size_t& hits) {
+    hits = 0;
+    return Measure([&] {
+        for (size_t key : keys) {
+            if (cache.get(key) != nullptr) {
+                ++hits;
+            } else {
+                cache.put(key, key);
+            }
+        }
+    });
+}
+
+void BenchLru(size_t n) {
+    const size_t universe = 1000000;
+    std::vector<size_t> keys = ZipfKeys(n, universe, 0.99, 42);
+    for (size_t capacity : {1000, 100000}) {
+        task::lru_cache<size_t, size_t> cache_task(capacity);
+        StdLruCache cache_std(capacity);
+        size_t hits_task = 0, hits_std = 0;
+        // первый проход прогревает кэш, измеряется второй
+        MeasureLru(cache_task, keys, hits_task);
+        MeasureLru(cache_std, keys, hits_std);
+        Measurement task_m = MeasureLru(cache_task, keys, hits_task);
+        Measurement std_m = MeasureLru(cache_std, keys, hits_std);
+        std::string name = "lru get/put zipf cap=" + std::to_string(capacity);
+        Report(name, n, task_m, std_m);
+        std::cout << std::left << std::setw(28) << name << " n=" << std::setw(10) << n
+                  << std::right << std::fixed << std::setprecision(2)
+                  << " hit rate: " << 100.0 * hits_task / n << "% "
+                  << " task: " << n / task_m.ms / 1000 << " Mops/s"
+                  << " std: " << n / std_m.ms / 1000 << " Mops/s" << std::endl;
+    }
+}
+
+
+// снимок конфигурации на каждый запрос: копия task::list против O(1) копии persistent_list
+void BenchPersistent(size_t n) {
+    const size_t config_size = 1000;
+    const size_t requests = std::max<size_t>(n / config_size, 1);
+    std::vector<size_t> config(config_size);
+    std::iota(config.begin(), config.end(), 0);
+    task::list<size_t> list_task;
+    list_task.insert(list_task.cend(), config.begin(), config.end());
+    task::persistent_list<size_t> list_persistent(config.begin(), config.end());
+
+    volatile size_t sink = 0;
+    Measurement copy_m = Measure([&] {
+        for (size_t i = 0; i < requests; ++i) {
+            task::list<size_t> snapshot(list_task);
+            sink = sink + snapshot.front();
+        }
+    });
+    Measurement snapshot_m = Measure([&] {
+        for (size_t i = 0; i < requests; ++i) {
+            task::persistent_list<size_t> snapshot = list_persistent.snapshot();
+            sink = sink + snapshot.front();
+        }
+    });
+    Report("snapshot/persistent vs copy", requests, snapshot_m, copy_m);
+
+    // каждый запрос получает свою версию с одним новым элементом в начале
+    copy_m = Measure([&] {
+        for (size_t i = 0; i < requests; ++i) {
+            task::list<size_t> version(list_task);
+            version.push_front(i);
+            sink = sink + version.front();
+        }
+    });
+    Measurement push_m = Measure([&] {
+        for (size_t i = 0; i < requests; ++i) {
+            task::persistent_list<size_t> version = list_persistent.push_front(i);
+            sink = sink + version.front();
+        }
+    });
+    Report("version/persistent vs copy", requests, push_m, copy_m);
+
+    // цена разделения: обход по элементам с двумя отдельными выделениями памяти (элемент и счетчик)
+    Measurement traverse_persistent = Measure([&] {
+        for (size_t i = 0; i < requests; ++i) {
+            sink = sink + std::accumulate(list_persistent.cbegin(), list_persistent.cend(), size_t(0));
+        }
+    });
+    Measurement traverse_list = Measure([&] {
+        for (size_t i = 0; i < requests; ++i) {
+            sink = sink + std::accumulate(list_task.cbegin(), list_task.cend(), size_t(0));
+        }
+    });
+    Report("traverse/persistent vs list", requests, traverse_persistent, traverse_list);
+}
+
+
+// односвязный список против task::list: в колонке task - forward_list, в колонке std - task::list
+template <class List, class Alloc>
+size_t PeakBytes(size_t n) {
+    task::allocation_stats stats;
+    List list((Alloc(&stats)));
+    FillRandom(list, n, 42);
+    return stats.peak_live_bytes;
+}
+
+void BenchForwardList(size_t n) {
+    task::forward_list<size_t> list_forward;
+    task::list<size_t> list_task;
+    volatile size_t sink = 0;
+
+    // стек: добавление и удаление в начале
+    Measurement forward_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_forward.push_front(i);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            list_forward.pop_front();
+        }
+    });
+    Measurement list_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_task.push_front(i);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            list_task.pop_front();
+        }
+    });
+    Report("forward_list/stack", n, forward_m, list_m);
+
+    // очередь: добавление в конец, удаление из начала
+    forward_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_forward.push_back(i);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            list_forward.pop_front();
+        }
+    });
+    list_m = Measure([&] {
+        for (size_t i = 0; i < n; ++i) {
+            list_task.push_back(i);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            list_task.pop_front();
+        }
+    });
+    Report("forward_list/queue", n, forward_m, list_m);
+
+    FillRandom(list_forward, n, 42);
+    FillRandom(list_task, n, 42);
+    forward_m = Measure([&] {
+        for (int rep = 0; rep < 10; ++rep) {
+            sink = sink + std::accumulate(list_forward.begin(), list_forward.end(), size_t(0));
+        }
+    });
+    list_m = Measure([&] {
+        for (int rep = 0; rep < 10; ++rep) {
+            sink = sink + std::accumulate(list_task.begin(), list_task.end(), size_t(0));
+        }
+    });
+    Report("forward_list/traverse x10", n, forward_m, list_m);
+    Report("forward_list/sort", n, Measure([&] { list_forward.sort(); }), Measure([&] { list_task.sort(); }));
+
+    using Alloc = task::counting_allocator<std::allocator<size_t>>;
+    std::cout << std::left << std::setw(28) << "forward_list/bytes" << " n=" << std::setw(10) << n
+              << std::right << std::fixed << std::setprecision(2)
+              << " forward_list: " << double(PeakBytes<task::forward_list<size_t, Alloc>, Alloc>(n)) / n
+              << " list: " << double(PeakBytes<task::list<size_t, Alloc>, Alloc>(n)) / n << std::endl;
+}
+
+
+// короткие списки: list_size элементов строятся, обходятся и уничтожаются
+template <class List>
+Measurement MeasureShortLists(size_t n, size_t list_size) {
+    volatile size_t sink = 0;
+    return Measure([&] {
+        for (size_t done = 0; done < n; done += list_size) {
+            List list;
+            for (size_t i = 0; i < list_size; ++i) {
+                list.push_back(i);
+            }
+            sink = sink + std::accumulate(list.begin(), list.end(), size_t(0));
+        }
+    });
+}
+
+void BenchSmallList(size_t n) {
+    // в колонке task - small_list со встроенной памятью на 8 элементов, в колонке std - task::list
+    for (size_t list_size : {4, 8, 16}) {
+        Report("small_list/size" + std::to_string(list_size), n,
+               MeasureShortLists<task::small_list<size_t, 8>>(n, list_size),
+               MeasureShortLists<task::list<size_t>>(n, list_size));
+    }
+}
+
+
+// обработка запроса: список из request_size элементов строится и целиком уничтожается
+template <class List, class MakeList>
+Measurement MeasureRequests(size_t n, size_t request_size, MakeList make_list) {
+    volatile size_t sink = 0;
+    return Measure([&] {
+        for (size_t done = 0; done < n; done += request_size) {
+            List list = make_list();
+            for (size_t i = 0; i < request_size; ++i) {
+                list.push_back(i);
+            }
+            sink = sink + list.back();
+        }
+    });
+}
+
+// ресурс на стеке, освобождаемый целиком после каждого запроса: куча не используется
+template <class List>
+Measurement MeasureMonotonicRequests(size_t n, size_t request_size) {
+    alignas(std::max_align_t) char buffer[1 << 14];
+    volatile size_t sink = 0;
+    return Measure([&] {
+        for (size_t done = 0; done < n; done += request_size) {
+            std::pmr::monotonic_buffer_resource resource(buffer, sizeof(buffer));
+            List list(&resource);
+            for (size_t i = 0; i < request_size; ++i) {
+                list.push_back(i);
+            }
+            sink = sink + list.back();
+        }
+    });
+}
+
+void BenchPmr(size_t n) {
+    const size_t request_size = 100;
+    Report("request build+drop/default", n,
+           MeasureRequests<task::list<size_t>>(n, request_size, [] { return task::list<size_t>(); }),
+           MeasureRequests<std::list<size_t>>(n, request_size, [] { return std::list<size_t>(); }));
+
+    Report("request build+drop/monotonic", n,
+           MeasureMonotonicRequests<task::pmr::list<size_t>>(n, request_size),
+           MeasureMonotonicRequests<std::pmr::list<size_t>>(n, request_size));
+
+    // пул, переживающий запросы: элементы возвращаются в него и переиспользуются
+    std::pmr::unsynchronized_pool_resource pool;
+    Report("request build+drop/pool", n,
+           MeasureRequests<task::pmr::list<size_t>>(n, request_size, [&] { return task::pmr::list<size_t>(&pool); }),
+           MeasureRequests<std::pmr::list<size_t>>(n, request_size, [&] { return std::pmr::list<size_t>(&pool); }));
+}
+
+
+// очередь производителей и потребителя, которую заменяет mpsc_list_queue: task::list под мьютексом
+struct MutexListQueue {
+    std::mutex mutex;
+    task::list<size_t> items;
+
+    void push_back(size_t value) {
+        std::lock_guard<std::mutex> lock(mutex);
+        items.push_back(value);
+    }
+    size_t drain(task::list<size_t>& to) {
+        std::lock_guard<std::mutex> lock(mutex);
+        size_t count = items.size();
+        to.splice(to.cend(), items);
+        return count;
+    }
+};
+
+struct QueueMeasurement {
+    double mops; // миллионов добавлений в секунду, от старта производителей до получения последнего элемента
+    double p99_ns; // 99-й перцентиль времени одного push_back
+};
+
+template <class Queue>
+QueueMeasurement MeasureQueue(size_t n, size_t producers) {
+    Queue queue;
+    size_t per_producer = n / producers;
+    std::vector<std::vector<long long>> latencies(producers, std::vector<long long>(per_producer));
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t p = 0; p < producers; ++p) {
+        threads.emplace_back([&queue, &latencies, p, per_producer] {
+            for (size_t i = 0; i < per_producer; ++i) {
+                auto before = std::chrono::steady_clock::now();
+                queue.push_back(i);
+                latencies[p][i] = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - before).count();
+            }
+        });
+    }
+    // потребитель забирает все накопившееся и освобождает элементы
+    task::list<size_t> received;
+    for (size_t count = 0; count < per_producer * producers;) {
+        size_t taken = queue.drain(received);
+        if (taken == 0) {
+            std::this_thread::yield();
+        }
+        count += taken;
+        received.clear();
+    }
+    auto finish = std::chrono::steady_clock::now();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    std::vector<long long> all;
+    all.reserve(per_producer * producers);
+    for (const auto& part : latencies) {
+        all.insert(all.end(), part.begin(), part.end());
+    }
+    auto p99 = all.begin() + all.size() * 99 / 100;
+    std::nth_element(all.begin(), p99, all.end());
+    double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+    return {per_producer * producers / ms / 1000, static_cast<double>(*p99)};
+}
+
+void BenchMpscQueue(size_t n) {
+    for (size_t producers = 1; producers <= 32; producers *= 2) {
+        QueueMeasurement task_m = MeasureQueue<task::mpsc_list_queue<size_t>>(n, producers);
+        QueueMeasurement mutex_m = MeasureQueue<MutexListQueue>(n, producers);
+        std::cout << std::left << std::setw(28) << "mpsc push/drain/" + std::to_string(producers) + "producers"
+                  << " n=" << std::setw(10) << n << std::right << std::fixed << std::setprecision(2)
+                  << " task: " << std::setw(8) << task_m.mops << " Mops/s p99 " << std::setw(8) << task_m.p99_ns << " ns"
+                  << " | mutex+list: " << std::setw(8) << mutex_m.mops << " Mops/s p99 " << std::setw(8) << mutex_m.p99_ns << " ns"
+                  << std::endl;
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 1000000;
+
+    BenchEmpty(n);
+    BenchEmplace(n);
+    BenchInsertRange(n);
+    BenchErase(n);
+    BenchRemove(n);
+    BenchCopyAssign(n);
+    BenchSort(n);
+    BenchParallelSort(n);
+    BenchParallelReduce(n);
+    BenchTraverse(n);
+    BenchIntrusive(n);
+    BenchCompact(n);
+    BenchAllocatorCalls(n);
+    BenchIndex(n);
+    BenchLru(n);
+    BenchPmr(n);
+    BenchPersistent(n);
+    BenchForwardList(n);
+    BenchSmallList(n);
+    BenchMpscQueue(n);
+}
@@ -0,0 +1,107 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// подсчет обращений к куче для замеров: подмена глобальных operator new / delete.
+// Определения не inline, поэтому заголовок подключается ровно в один .cpp каждой программы замеров.
+// Счетчики у каждого потока свои: замер учитывает выделения только вызвавшего его потока
+static thread_local size_t allocations = 0;
+static thread_local size_t allocated_bytes = 0;
+
+// все варианты operator new / delete проходят через эти две функции. noinline: иначе GCC, встроив
+// delete в место вызова, видит free() для указателя из operator new и выдает -Wmismatched-new-delete
+[[gnu::noinline]] static void* CountedAllocate(size_t size, size_t alignment) {
+    ++allocations;
+    allocated_bytes += size;
+    void* p = nullptr;
+    if (alignment <= alignof(std::max_align_t)) {
+        p = std::malloc(size == 0 ? 1 : size);
+    }
+    else {
+        // размер для aligned_alloc должен быть кратен выравниванию
+        p = std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    }
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+[[gnu::noinline]] static void CountedFree(void* p) noexcept {
+    std::free(p);
+}
+
+void* operator new(size_t size) {
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new[](size_t size) {
+    return CountedAllocate(size, alignof(std::max_align_t));
+}
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return CountedAllocate(size, static_cast<size_t>(alignment));
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return CountedAllocate(size, alignof(std::max_align_t));
+    }
+    catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+    try {
+        return CountedAllocate(size, alignof(std::max_align_t));
+    }
+    catch (const std::bad_alloc&) {
+        return nullptr;
+    }
+}
+
+void operator delete(void* p) noexcept {
+    CountedFree(p);
+}
+
+void operator delete[](void* p) noexcept {
+    CountedFree(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    CountedFree(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    CountedFree(p);
+}
+
+void operator delete(void* p, std::align_val_t) noexcept {
+    CountedFree(p);
+}
+
+void operator delete[](void* p, std::align_val_t) noexcept {
+    CountedFree(p);
+}
+
+void operator delete(void* p, size_t, std::align_val_t) noexcept {
+    CountedFree(p);
+}
+
+void operator delete[](void* p, size_t, std::align_val_t) noexcept {
+    CountedFree(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept {
+    CountedFree(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept {
+    CountedFree(p);
+}
@@ -0,0 +1,402 @@
+// набор замеров task::list против std::list по операциям и типам элементов.
+// Каждый замер выполняется в отдельном процессе (fork): у него своя чистая куча и свой пиковый RSS.
+// Вывод по умолчанию - CSV, одна строка на (тип, операция, реализация), порядок строк постоянный,
+// поэтому результаты разных коммитов можно сравнивать diff'ом; --table печатает таблицу task | std.
+// Запуск: ./bench_suite.sh [n] [--reps=k] [--table]
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <list>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+#include "src/list.h"
+#include "bench/counting_new.h"
+
+#ifndef BENCH_OPT
+#define BENCH_OPT "unknown"
+#endif
+
+
+// типы элементов
+
+// 64-байтная тривиально копируемая структура
+struct Pod64 {
+    uint64_t key;
+    uint64_t payload[7];
+
+    Pod64(uint64_t k = 0) : key(k), payload() {}
+    bool operator<(const Pod64& other) const { return key < other.key; }
+    bool operator==(const Pod64& other) const { return key == other.key; }
+};
+
+// тяжелый тип в духе MoveTester из тестов: копирование выделяет память, перемещение дешевое
+struct Heavy {
+    size_t key;
+    std::string payload;
+
+    Heavy(size_t k = 0) : key(k), payload(64, static_cast<char>('a' + k % 26)) {}
+    Heavy(const Heavy&) = default;
+    Heavy(Heavy&&) noexcept = default;
+    Heavy& operator=(const Heavy&) = default;
+    Heavy& operator=(Heavy&&) noexcept = default;
+    bool operator<(const Heavy& other) const { return key < other.key; }
+    bool operator==(const Heavy& other) const { return key == other.key; }
+};
+
+// создание значения по ключу и emplace_back из аргументов конструктора
+template <class T>
+struct Gen {
+    static T make(size_t key) { return T(key); }
+    template <class List>
+    static void emplace_back(List& list, size_t key) { list.emplace_back(key); }
+    static const char* name();
+};
+
+template <>
+const char* Gen<int>::name() { return "int"; }
+template <>
+const char* Gen<Pod64>::name() { return "pod64"; }
+template <>
+const char* Gen<Heavy>::name() { return "heavy"; }
+
+template <>
+struct Gen<std::string> {
+    // длиннее буфера малой строки: каждое значение занимает память в куче
+    static std::string make(size_t key) {
+        std::string s = std::to_string(key);
+        return std::string(24 - s.size(), '0') + s;
+    }
+    template <class List>
+    static void emplace_back(List& list, size_t key) { list.emplace_back(size_t(24), static_cast<char>('a' + key % 26)); }
+    static const char* name() { return "string"; }
+};
+
+template <class T>
+std::vector<T> Values(size_t n, size_t key_range, unsigned seed) {
+    std::mt19937_64 rand(seed);
+    std::vector<T> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        values.push_back(Gen<T>::make(rand() % key_range));
+    }
+    return values;
+}
+
+
+// замер одной операции: время и выделения памяти только внутри f
+struct Sample {
+    size_t ops;
+    double ns;
+    size_t allocs;
+};
+
+template <class F>
+Sample Timed(size_t ops, F&& f) {
+    size_t allocs_before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto finish = std::chrono::steady_clock::now();
+    return {ops, std::chrono::duration<double, std::nano>(finish - start).count(), allocations - allocs_before};
+}
+
+template <class List, class T>
+void Fill(List& list, const std::vector<T>& values) {
+    for (const auto& v : values) {
+        list.push_back(v);
+    }
+}
+
+// операции; List - task::list<T> или std::list<T>
+
+template <class List, class T>
+Sample PushBack(size_t n) {
+    std::vector<T> values = Values<T>(n, n, 1);
+    List list;
+    return Timed(n, [&] { for (const T& v : values) list.push_back(v); });
+}
+
+template <class List, class T>
+Sample PushFront(size_t n) {
+    std::vector<T> values = Values<T>(n, n, 1);
+    List list;
+    return Timed(n, [&] { for (const T& v : values) list.push_front(v); });
+}
+
+template <class List, class T>
+Sample PopBack(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, n, 1));
+    return Timed(n, [&] { while (!list.empty()) list.pop_back(); });
+}
+
+template <class List, class T>
+Sample PopFront(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, n, 1));
+    return Timed(n, [&] { while (!list.empty()) list.pop_front(); });
+}
+
+template <class List, class T>
+Sample EmplaceBack(size_t n) {
+    List list;
+    return Timed(n, [&] { for (size_t i = 0; i < n; ++i) Gen<T>::emplace_back(list, i); });
+}
+
+// вставка перед случайным из уже вставленных элементов
+template <class List, class T>
+Sample InsertRandom(size_t n) {
+    std::vector<T> values = Values<T>(n, n, 1);
+    std::vector<typename List::iterator> its;
+    its.reserve(n);
+    List list;
+    list.push_back(values[0]);
+    its.push_back(list.begin());
+    std::mt19937_64 rand(2);
+    return Timed(n - 1, [&] {
+        for (size_t i = 1; i < n; ++i) {
+            its.push_back(list.insert(its[rand() % its.size()], values[i]));
+        }
+    });
+}
+
+// удаление всех элементов в случайном порядке
+template <class List, class T>
+Sample EraseRandom(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, n, 1));
+    std::vector<typename List::iterator> its;
+    its.reserve(n);
+    for (auto it = list.begin(); it != list.end(); ++it) {
+        its.push_back(it);
+    }
+    std::shuffle(its.begin(), its.end(), std::mt19937_64(2));
+    return Timed(n, [&] { for (auto it : its) list.erase(it); });
+}
+
+template <class List, class T>
+Sample Copy(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, n, 1));
+    // копия уничтожается вне замера; место под нее выделено заранее
+    std::vector<List> copies;
+    copies.reserve(1);
+    return Timed(n, [&] { copies.emplace_back(list); });
+}
+
+// ns/op - одно перемещение всего списка
+template <class List, class T>
+Sample Move(size_t n) {
+    const size_t rounds = 1000;
+    List list;
+    Fill(list, Values<T>(n, n, 1));
+    return Timed(2 * rounds, [&] {
+        for (size_t i = 0; i < rounds; ++i) {
+            List moved(std::move(list));
+            list = std::move(moved);
+        }
+    });
+}
+
+template <class List, class T>
+Sample Sort(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, n, 1));
+    return Timed(n, [&] { list.sort(); });
+}
+
+template <class List, class T>
+Sample Merge(size_t n) {
+    List a, b;
+    Fill(a, Values<T>(n / 2, n, 1));
+    Fill(b, Values<T>(n - n / 2, n, 2));
+    a.sort();
+    b.sort();
+    return Timed(n, [&] { a.merge(b); });
+}
+
+// перенос элементов по одному из начала одного списка в конец другого
+template <class List, class T>
+Sample Splice(size_t n) {
+    List from, to;
+    Fill(from, Values<T>(n, n, 1));
+    return Timed(n, [&] { for (size_t i = 0; i < n; ++i) to.splice(to.end(), from, from.begin()); });
+}
+
+// отсортированный список, в среднем по 4 повтора каждого значения
+template <class List, class T>
+Sample Unique(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, std::max<size_t>(n / 4, 1), 1));
+    list.sort();
+    return Timed(n, [&] { list.unique(); });
+}
+
+// удаляется около четверти элементов
+template <class List, class T>
+Sample Remove(size_t n) {
+    List list;
+    Fill(list, Values<T>(n, 4, 1));
+    T value = Gen<T>::make(0);
+    return Timed(n, [&] { list.remove(value); });
+}
+
+
+// запуск в отдельном процессе
+
+struct Result {
+    double ns_per_op;
+    double allocs_per_op;
+    long peak_rss_kb;
+};
+
+Result ToResult(const Sample& sample) {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    size_t ops = std::max<size_t>(sample.ops, 1);
+    return {sample.ns / ops, static_cast<double>(sample.allocs) / ops, usage.ru_maxrss};
+}
+
+Result RunIsolated(Sample (*bench)(size_t), size_t n) {
+    int fds[2];
+    pid_t pid = -1;
+    if (pipe(fds) == 0) {
+        pid = fork();
+    }
+    if (pid < 0) {
+        // без fork замер идет в этом процессе, пиковый RSS тогда общий для всех замеров
+        return ToResult(bench(n));
+    }
+    if (pid == 0) {
+        close(fds[0]);
+        Result result = ToResult(bench(n));
+        ssize_t written = write(fds[1], &result, sizeof(result));
+        _exit(written == sizeof(result) ? 0 : 1);
+    }
+    close(fds[1]);
+    Result result{-1, -1, -1};
+    if (read(fds[0], &result, sizeof(result)) != sizeof(result)) {
+        result = {-1, -1, -1};
+    }
+    close(fds[0]);
+    waitpid(pid, nullptr, 0);
+    return result;
+}
+
+// лучший из reps запусков: ns/op - минимум, выделения и RSS - по тому же запуску
+Result RunBest(Sample (*bench)(size_t), size_t n, size_t reps) {
+    Result best = RunIsolated(bench, n);
+    for (size_t i = 1; i < reps; ++i) {
+        Result result = RunIsolated(bench, n);
+        if (result.ns_per_op >= 0 && (best.ns_per_op < 0 || result.ns_per_op < best.ns_per_op)) {
+            best = result;
+        }
+    }
+    return best;
+}
+
+
+struct Operation {
+    const char* name;
+    Sample (*task_bench)(size_t);
+    Sample (*std_bench)(size_t);
+};
+
+#define OPERATION(name, fn, T) {name, fn<task::list<T>, T>, fn<std::list<T>, T>}
+
+template <class T>
+std::vector<Operation> Operations() {
+    return {
+        OPERATION("push_back", PushBack, T),
+        OPERATION("push_front", PushFront, T),
+        OPERATION("pop_back", PopBack, T),
+        OPERATION("pop_front", PopFront, T),
+        OPERATION("emplace_back", EmplaceBack, T),
+        OPERATION("insert_random", InsertRandom, T),
+        OPERATION("erase_random", EraseRandom, T),
+        OPERATION("copy", Copy, T),
+        OPERATION("move", Move, T),
+        OPERATION("sort", Sort, T),
+        OPERATION("merge", Merge, T),
+        OPERATION("splice", Splice, T),
+        OPERATION("unique", Unique, T),
+        OPERATION("remove", Remove, T),
+    };
+}
+
+struct Options {
+    size_t n = 100000;
+    size_t reps = 3;
+    bool table = false;
+    bool header = true;
+};
+
+void PrintRow(const char* type, const char* op, const char* impl, size_t n, const Result& r) {
+    std::cout << "list," << BENCH_OPT << "," << type << "," << op << "," << impl << "," << n << ","
+              << std::fixed << std::setprecision(2) << r.ns_per_op << "," << std::setprecision(3) << r.allocs_per_op
+              << "," << r.peak_rss_kb << "\n";
+}
+
+void PrintTableRow(const char* type, const char* op, size_t n, const Result& t, const Result& s) {
+    std::cout << std::left << std::setw(8) << type << std::setw(15) << op << " n=" << std::setw(8) << n
+              << std::right << std::fixed << std::setprecision(2)
+              << " task: " << std::setw(9) << t.ns_per_op << " ns/op " << std::setw(6) << std::setprecision(2)
+              << t.allocs_per_op << " allocs/op " << std::setw(7) << t.peak_rss_kb << " KB"
+              << " | std: " << std::setw(9) << s.ns_per_op << " ns/op " << std::setw(6) << s.allocs_per_op
+              << " allocs/op " << std::setw(7) << s.peak_rss_kb << " KB"
+              << " | x" << std::setprecision(2) << s.ns_per_op / t.ns_per_op << std::endl;
+}
+
+template <class T>
+void RunType(const Options& options) {
+    for (const Operation& op : Operations<T>()) {
+        Result task_result = RunBest(op.task_bench, options.n, options.reps);
+        Result std_result = RunBest(op.std_bench, options.n, options.reps);
+        if (options.table) {
+            PrintTableRow(Gen<T>::name(), op.name, options.n, task_result, std_result);
+        }
+        else {
+            PrintRow(Gen<T>::name(), op.name, "task", options.n, task_result);
+            PrintRow(Gen<T>::name(), op.name, "std", options.n, std_result);
+            std::cout.flush();
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--table") == 0) {
+            options.table = true;
+        }
+        else if (std::strcmp(argv[i], "--no-header") == 0) {
+            options.header = false;
+        }
+        else if (std::strncmp(argv[i], "--reps=", 7) == 0) {
+            options.reps = std::max<size_t>(std::strtoull(argv[i] + 7, nullptr, 10), 1);
+        }
+        else {
+            options.n = std::max<size_t>(std::strtoull(argv[i], nullptr, 10), 2);
+        }
+    }
+    if (options.table) {
+        std::cout << "optimization: " << BENCH_OPT << std::endl;
+    }
+    else if (options.header) {
+        std::cout << "suite,opt,type,op,impl,n,ns_per_op,allocs_per_op,peak_rss_kb\n";
+    }
+
+    RunType<int>(options);
+    RunType<std::string>(options);
+    RunType<Pod64>(options);
+    RunType<Heavy>(options);
+}
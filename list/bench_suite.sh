@@ -0,0 +1,10 @@
+#!/bin/bash
+
+set -e
+
+# набор замеров при -O2 и -O3; вывод CSV можно сохранить и сравнить с другим коммитом через diff
+for opt in O2 O3; do
+    g++ -std=c++17 -$opt -Wall -Wextra -DBENCH_OPT=\"$opt\" -I./ bench/suite.cpp -o list_bench_suite_$opt
+done
+./list_bench_suite_O2 "$@"
+./list_bench_suite_O3 --no-header "$@"
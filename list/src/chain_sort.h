@@ -0,0 +1,112 @@
+#pragma once
+#include <cstddef>
+#include <utility>
+
+namespace task {
+
+// сортировка слиянием для цепочек узлов, связанных только через next и завершенных nullptr:
+// общая часть sort и merge у list, forward_list, small_list и intrusive_list. Узлы только
+// переставляются, память не выделяется, значения не копируются и не перемещаются.
+// less(a, b) сравнивает значения узлов a и b; prev и границы списка восстанавливает вызывающий
+
+// слияние отсортированной цепочки b в отсортированную a, b становится пустой. При равенстве первым
+// идет элемент из a, поэтому слияние устойчиво. При исключении из less все элементы остаются в a
+template <class Node, class Less>
+void merge_chains(Node*& a, Node*& b, Less& less);
+
+// сортировка цепочки снизу вверх на месте, устойчивая; O(n log n) сравнений и O(1) памяти.
+// При исключении из less все элементы остаются в chain в неопределенном порядке
+template <class Node, class Less>
+void sort_chain(Node*& chain, Less& less);
+
+
+    template <class Node, class Less>
+    void merge_chains(Node*& a, Node*& b, Less& less)
+    {
+        Node *result = nullptr;
+        Node **tail = &result; // куда записать следующий элемент результата
+        try {
+            while (a != nullptr && b != nullptr) {
+                if (less(b, a)) {
+                    *tail = b;
+                    b = b->next;
+                }
+                else {
+                    *tail = a;
+                    a = a->next;
+                }
+                tail = &(*tail)->next;
+            }
+        }
+        catch (...) {
+            // собираем в a уже слитую часть и остатки обеих цепочек
+            *tail = a;
+            while (*tail != nullptr) {
+                tail = &(*tail)->next;
+            }
+            *tail = b;
+            a = result;
+            b = nullptr;
+            throw;
+        }
+        *tail = (a != nullptr) ? a : b;
+        a = result;
+        b = nullptr;
+    }
+
+    template <class Node, class Less>
+    void sort_chain(Node*& chain, Less& less)
+    {
+        // bins[k] - отсортированная цепочка из 2^k элементов (или nullptr);
+        // чем больше k, тем раньше в исходной цепочке стояли элементы
+        Node *bins[sizeof(size_t) * 8] = {};
+        size_t bins_used = 0;
+        Node *node = chain;
+        Node *carry = nullptr;
+        Node *result = nullptr;
+        try {
+            while (node != nullptr) {
+                carry = node;
+                node = node->next;
+                carry->next = nullptr;
+                // как при двоичном сложении переносим carry, пока ячейка занята
+                size_t k = 0;
+                while (bins[k] != nullptr) {
+                    merge_chains(bins[k], carry, less);
+                    std::swap(bins[k], carry);
+                    ++k;
+                }
+                bins[k] = carry;
+                carry = nullptr;
+                if (k + 1 > bins_used) {
+                    bins_used = k + 1;
+                }
+            }
+
+            // сливаем оставшиеся цепочки, более ранние элементы передаем первыми
+            for (size_t k = 0; k < bins_used; ++k) {
+                if (bins[k] != nullptr) {
+                    merge_chains(bins[k], result, less);
+                    std::swap(bins[k], result);
+                }
+            }
+        }
+        catch (...) {
+            // каждый элемент лежит ровно в одной из частей: сцепляем их все в chain
+            Node **tail = &chain;
+            auto append = [&tail](Node* part) {
+                for (*tail = part; *tail != nullptr; tail = &(*tail)->next) {
+                }
+            };
+            append(result);
+            append(carry);
+            for (size_t k = 0; k < bins_used; ++k) {
+                append(bins[k]);
+            }
+            append(node);
+            throw;
+        }
+        chain = result;
+    }
+
+}  // namespace task
@@ -0,0 +1,137 @@
+#pragma once
+#include <algorithm> // для std::max
+#include <cstddef>
+#include <memory> // для allocator_traits
+#include <utility>
+
+namespace task {
+
+// счетчики обращений к аллокатору
+struct allocation_stats {
+    size_t allocations = 0; // вызовы allocate
+    size_t deallocations = 0; // вызовы deallocate
+    size_t constructions = 0; // вызовы construct
+    size_t destructions = 0; // вызовы destroy
+    size_t bytes_allocated = 0;
+    size_t bytes_deallocated = 0;
+    size_t live_bytes = 0; // выделено и еще не освобождено
+    size_t peak_live_bytes = 0; // максимум live_bytes
+
+    void reset() { *this = allocation_stats(); }
+
+    void on_allocate(size_t bytes) {
+        ++allocations;
+        bytes_allocated += bytes;
+        live_bytes += bytes;
+        peak_live_bytes = std::max(peak_live_bytes, live_bytes);
+    }
+    void on_deallocate(size_t bytes) {
+        ++deallocations;
+        bytes_deallocated += bytes;
+        live_bytes -= bytes;
+    }
+};
+
+// общие счетчики всех counting_allocator независимо от типа и экземпляра
+inline allocation_stats& global_allocation_stats()
+{
+    static allocation_stats stats;
+    return stats;
+}
+
+// адаптер, считающий обращения к аллокатору Alloc: каждое обращение учитывается в глобальных
+// счетчиках и, если задан stats, в счетчиках экземпляра. Копии и rebind-копии аллокатора пишут
+// в те же счетчики, поэтому stats контейнера учитывает и его элементы, и служебные структуры.
+// Счетчики не атомарны: аллокатор рассчитан на использование из одного потока.
+// Равенство и правила передачи аллокатора между контейнерами - как у Alloc
+template <class Alloc>
+class counting_allocator {
+private:
+    using traits = std::allocator_traits<Alloc>;
+
+    template <class>
+    friend class counting_allocator;
+
+    Alloc inner;
+    allocation_stats *stats_;
+
+public:
+    using value_type = typename traits::value_type;
+    using pointer = typename traits::pointer;
+    using const_pointer = typename traits::const_pointer;
+    using size_type = typename traits::size_type;
+    using difference_type = typename traits::difference_type;
+    using propagate_on_container_copy_assignment = typename traits::propagate_on_container_copy_assignment;
+    using propagate_on_container_move_assignment = typename traits::propagate_on_container_move_assignment;
+    using propagate_on_container_swap = typename traits::propagate_on_container_swap;
+    using is_always_equal = typename traits::is_always_equal;
+
+    template <class U>
+    struct rebind {
+        using other = counting_allocator<typename traits::template rebind_alloc<U>>;
+    };
+
+    counting_allocator() noexcept(noexcept(Alloc())) : inner(), stats_(nullptr) {};
+    explicit counting_allocator(allocation_stats* stats, const Alloc& alloc = Alloc()) noexcept
+        : inner(alloc), stats_(stats) {};
+    template <class OtherAlloc>
+    counting_allocator(const counting_allocator<OtherAlloc>& other) noexcept
+        : inner(other.inner), stats_(other.stats_) {};
+
+    // счетчики экземпляра или nullptr
+    allocation_stats* stats() const noexcept { return stats_; }
+    const Alloc& inner_allocator() const noexcept { return inner; }
+
+    pointer allocate(size_type n)
+    {
+        pointer p = traits::allocate(inner, n);
+        global_allocation_stats().on_allocate(n * sizeof(value_type));
+        if (stats_ != nullptr) {
+            stats_->on_allocate(n * sizeof(value_type));
+        }
+        return p;
+    }
+
+    void deallocate(pointer p, size_type n) noexcept
+    {
+        global_allocation_stats().on_deallocate(n * sizeof(value_type));
+        if (stats_ != nullptr) {
+            stats_->on_deallocate(n * sizeof(value_type));
+        }
+        traits::deallocate(inner, p, n);
+    }
+
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        traits::construct(inner, p, std::forward<Args>(args)...);
+        ++global_allocation_stats().constructions;
+        if (stats_ != nullptr) {
+            ++stats_->constructions;
+        }
+    }
+
+    template <class U>
+    void destroy(U* p)
+    {
+        ++global_allocation_stats().destructions;
+        if (stats_ != nullptr) {
+            ++stats_->destructions;
+        }
+        traits::destroy(inner, p);
+    }
+
+    size_type max_size() const noexcept { return traits::max_size(inner); }
+
+    counting_allocator select_on_container_copy_construction() const
+    {
+        return counting_allocator(stats_, traits::select_on_container_copy_construction(inner));
+    }
+
+    template <class OtherAlloc>
+    bool operator==(const counting_allocator<OtherAlloc>& other) const noexcept { return inner == other.inner; }
+    template <class OtherAlloc>
+    bool operator!=(const counting_allocator<OtherAlloc>& other) const noexcept { return !(inner == other.inner); }
+};
+
+}  // namespace task
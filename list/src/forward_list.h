@@ -0,0 +1,886 @@
+#pragma once
+#include <functional> // для std::less, std::equal_to
+#include <initializer_list>
+#include <iterator>
+#include <memory> // для allocator_traits
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+#include "chain_sort.h"
+#include "list.h" // has_deallocate_chain, make_obj_using_allocator
+
+namespace task {
+
+// односвязный список: элемент хранит только next, поэтому занимает на один указатель меньше,
+// чем элемент task::list, а вставка и удаление меняют одну связь. Операции выполняются после
+// позиции (insert_after, erase_after, splice_after), перед первым элементом стоит before_begin().
+// Дополнительно хранится указатель на последний элемент: push_back за O(1), поэтому список
+// подходит и для стека, и для очереди. Размер не хранится (как у std::forward_list), поэтому
+// splice_after диапазона не считает его элементы.
+// Работа с аллокатором - как у task::list: allocator_traits, propagate_on_container_*,
+// select_on_container_copy_construction, поэлементное перемещение при неравных аллокаторах
+template<class T, class Alloc = std::allocator<T>>
+class forward_list {
+private:
+    class BaseNode { // связь элемента, без данных
+    public:
+        BaseNode *next;
+        explicit BaseNode(BaseNode* n = nullptr) noexcept : next(n) {};
+    };
+    class Node : public BaseNode {
+    public:
+        T data;
+        template <class... Args>
+        Node(BaseNode* n, Args&&... args) : BaseNode(n), data(std::forward<Args>(args)...) {};
+
+        // конструирование с аллокатором, как у элементов task::list
+        using allocator_type = Alloc;
+        template <class... Args>
+        Node(std::allocator_arg_t, const Alloc& alloc, BaseNode* n, Args&&... args)
+            : BaseNode(n), data(make_obj_using_allocator<T>(alloc, std::forward<Args>(args)...)) {};
+    };
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<allocator_type>;
+    allocator_type allocator;
+    // head.next - первый элемент; у последнего элемента next == nullptr
+    BaseNode head;
+    BaseNode *tail; // последний элемент или &head у пустого списка
+
+    static T& value(BaseNode* node) { return static_cast<Node*>(node)->data; }
+
+    template <class... Args>
+    Node* create_node(BaseNode* next, Args&&... args);
+    // уничтожение элементов цепочки, начиная с node, до nullptr
+    void destroy_chain(BaseNode* node) noexcept;
+    // перенос всех элементов other в пустой список с равным аллокатором
+    void steal(forward_list& other) noexcept;
+    // присваивание значений [first, last) существующим элементам, создание недостающих и удаление лишних
+    template <class InputIt>
+    void assign_elements(InputIt first, InputIt last);
+    // последний элемент цепочки, начиная с node (node != nullptr)
+    static BaseNode* last_of(BaseNode* node) noexcept;
+
+    template <class InputIt>
+    using RequireInputIter = std::enable_if_t<std::is_convertible<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>;
+
+public:
+    class iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        iterator() : ptr(nullptr) {};
+
+        iterator& operator++() { ptr = ptr->next; return *this; }
+        iterator operator++(int) { iterator it = *this; ptr = ptr->next; return it; }
+        reference operator*() const { return value(ptr); }
+        pointer operator->() const { return &value(ptr); }
+
+        bool operator==(iterator other) const { return ptr == other.ptr; }
+        bool operator!=(iterator other) const { return ptr != other.ptr; }
+
+        friend class forward_list;
+    private:
+        BaseNode *ptr;
+    };
+
+    class const_iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() : ptr(nullptr) {};
+        const_iterator(const iterator& it) : ptr(it.ptr) {};
+
+        const_iterator& operator++() { ptr = ptr->next; return *this; }
+        const_iterator operator++(int) { const_iterator it = *this; ptr = ptr->next; return it; }
+        reference operator*() const { return static_cast<const Node*>(ptr)->data; }
+        pointer operator->() const { return &static_cast<const Node*>(ptr)->data; }
+
+        bool operator==(const_iterator other) const { return ptr == other.ptr; }
+        bool operator!=(const_iterator other) const { return ptr != other.ptr; }
+
+        friend class forward_list;
+    private:
+        const BaseNode *ptr;
+    };
+
+    forward_list() noexcept(noexcept(Alloc()));
+    explicit forward_list(const Alloc& alloc) noexcept;
+    forward_list(size_t count, const T& value, const Alloc& alloc = Alloc());
+    explicit forward_list(size_t count, const Alloc& alloc = Alloc());
+    template <class InputIt, class = RequireInputIter<InputIt>>
+    forward_list(InputIt first, InputIt last, const Alloc& alloc = Alloc());
+    forward_list(std::initializer_list<T> ilist, const Alloc& alloc = Alloc());
+
+    forward_list(const forward_list& other);
+    forward_list(const forward_list& other, const Alloc& alloc);
+    forward_list(forward_list&& other) noexcept;
+    forward_list(forward_list&& other, const Alloc& alloc);
+    forward_list& operator=(const forward_list& other);
+    forward_list& operator=(forward_list&& other) noexcept(
+        std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Alloc>::is_always_equal::value);
+
+    ~forward_list();
+
+    Alloc get_allocator() const;
+
+    T& front();
+    const T& front() const;
+    // последний элемент, O(1)
+    T& back();
+    const T& back() const;
+
+    iterator before_begin();
+    const_iterator cbefore_begin() const;
+    iterator begin();
+    iterator end();
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    bool empty() const;
+    size_t max_size() const;
+    void clear();
+
+    iterator insert_after(const_iterator pos, const T& value);
+    iterator insert_after(const_iterator pos, T&& value);
+    iterator insert_after(const_iterator pos, size_t count, const T& value);
+    template <class InputIt, class = RequireInputIter<InputIt>>
+    iterator insert_after(const_iterator pos, InputIt first, InputIt last);
+    template <class... Args>
+    iterator emplace_after(const_iterator pos, Args&&... args);
+
+    // удаление элемента после pos, возвращает итератор на следующий за удаленным
+    iterator erase_after(const_iterator pos);
+    // удаление элементов (first, last)
+    iterator erase_after(const_iterator first, const_iterator last);
+
+    void push_front(const T& value);
+    void push_front(T&& value);
+    template <class... Args>
+    void emplace_front(Args&&... args);
+    void pop_front();
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <class... Args>
+    void emplace_back(Args&&... args);
+
+    void swap(forward_list& other);
+
+    // перенос элементов за O(1) (для диапазона - O(длины), если он заканчивается в конце other:
+    // нужно найти новый последний элемент other); аллокаторы списков должны быть равны
+    void splice_after(const_iterator pos, forward_list& other);
+    // перенос элемента, следующего за it
+    void splice_after(const_iterator pos, forward_list& other, const_iterator it);
+    // перенос элементов (first, last)
+    void splice_after(const_iterator pos, forward_list& other, const_iterator first, const_iterator last);
+
+    void merge(forward_list& other);
+    template <class Compare>
+    void merge(forward_list& other, Compare comp);
+    size_t remove(const T& value);
+    template <class UnaryPredicate>
+    size_t remove_if(UnaryPredicate pred);
+    void reverse() noexcept;
+    size_t unique();
+    template <class BinaryPredicate>
+    size_t unique(BinaryPredicate pred);
+    // устойчивая сортировка слиянием снизу вверх: только перестановка указателей,
+    // без выделения памяти и без перемещения элементов
+    void sort();
+    template <class Compare>
+    void sort(Compare comp);
+};
+
+namespace pmr {
+    template <class T>
+    using forward_list = task::forward_list<T, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
+
+    template <class T, class Alloc>
+    template <class... Args>
+    typename forward_list<T, Alloc>::Node* forward_list<T, Alloc>::create_node(BaseNode* next, Args&&... args)
+    {
+        Node *node = node_traits::allocate(allocator, 1);
+        try {
+            node_traits::construct(allocator, node, next, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(allocator, node, 1);
+            throw;
+        }
+        return node;
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::destroy_chain(BaseNode* node) noexcept
+    {
+        // next - первое поле элемента, поэтому цепочка уже имеет вид, который ожидает deallocate_chain
+        BaseNode *chain = node;
+        size_t count = 0;
+        while (node != nullptr) {
+            Node *to_del = static_cast<Node*>(node);
+            node = node->next;
+            node_traits::destroy(allocator, to_del);
+            if constexpr (!has_deallocate_chain<allocator_type>::value) {
+                node_traits::deallocate(allocator, to_del, 1);
+            }
+            ++count;
+        }
+        if constexpr (has_deallocate_chain<allocator_type>::value) {
+            if (chain != nullptr) {
+                allocator.deallocate_chain(static_cast<Node*>(chain), count);
+            }
+        }
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::steal(forward_list& other) noexcept
+    {
+        if (other.head.next != nullptr) {
+            head.next = other.head.next;
+            tail = other.tail;
+            other.head.next = nullptr;
+            other.tail = &other.head;
+        }
+    }
+
+    template <class T, class Alloc>
+    template <class InputIt>
+    void forward_list<T, Alloc>::assign_elements(InputIt first, InputIt last)
+    {
+        // присваиваем значения уже существующим элементам, память выделяем только для недостающих
+        BaseNode *prev = &head;
+        for (; prev->next != nullptr && first != last; prev = prev->next, ++first) {
+            value(prev->next) = *first;
+        }
+        if (first == last) {
+            const_iterator pos;
+            pos.ptr = prev;
+            erase_after(pos, cend());
+        }
+        else {
+            const_iterator pos;
+            pos.ptr = prev;
+            insert_after(pos, first, last);
+        }
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::BaseNode* forward_list<T, Alloc>::last_of(BaseNode* node) noexcept
+    {
+        while (node->next != nullptr) {
+            node = node->next;
+        }
+        return node;
+    }
+
+    // конструкторы пустого списка не выделяют память
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list() noexcept(noexcept(Alloc()))
+        : allocator(), head(), tail(&head)
+    {
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(const Alloc& alloc) noexcept
+        : allocator(alloc), head(), tail(&head)
+    {
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(size_t count, const T& value, const Alloc& alloc) : forward_list(alloc)
+    {
+        insert_after(cbefore_begin(), count, value);
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(size_t count, const Alloc& alloc) : forward_list(alloc)
+    {
+        for (; count > 0; --count) {
+            emplace_back();
+        }
+    }
+
+    template <class T, class Alloc>
+    template <class InputIt, class>
+    forward_list<T, Alloc>::forward_list(InputIt first, InputIt last, const Alloc& alloc) : forward_list(alloc)
+    {
+        insert_after(cbefore_begin(), first, last);
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(std::initializer_list<T> ilist, const Alloc& alloc) : forward_list(alloc)
+    {
+        insert_after(cbefore_begin(), ilist.begin(), ilist.end());
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(const forward_list& other)
+        : forward_list(other, std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+    {
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(const forward_list& other, const Alloc& alloc) : forward_list(alloc)
+    {
+        insert_after(cbefore_begin(), other.cbegin(), other.cend());
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(forward_list&& other) noexcept
+        : allocator(std::move(other.allocator)), head(), tail(&head)
+    {
+        steal(other);
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::forward_list(forward_list&& other, const Alloc& alloc) : forward_list(alloc)
+    {
+        if (allocator == other.allocator) {
+            steal(other);
+        }
+        else {
+            insert_after(cbefore_begin(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>& forward_list<T, Alloc>::operator=(const forward_list& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+            // элементы освобождаются тем аллокатором, которым были выделены
+            if (allocator != other.allocator) {
+                clear();
+            }
+            allocator = other.allocator;
+        }
+        assign_elements(other.cbegin(), other.cend());
+        return *this;
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>& forward_list<T, Alloc>::operator=(forward_list&& other) noexcept(
+        std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+        std::allocator_traits<Alloc>::is_always_equal::value)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+            clear();
+            allocator = std::move(other.allocator);
+            steal(other);
+        }
+        else if (allocator == other.allocator) {
+            clear();
+            steal(other);
+        }
+        else {
+            assign_elements(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
+        return *this;
+    }
+
+    template <class T, class Alloc>
+    forward_list<T, Alloc>::~forward_list()
+    {
+        clear();
+    }
+
+    template <class T, class Alloc>
+    Alloc forward_list<T, Alloc>::get_allocator() const
+    {
+        return Alloc(allocator);
+    }
+
+    template <class T, class Alloc>
+    T& forward_list<T, Alloc>::front()
+    {
+        return value(head.next);
+    }
+
+    template <class T, class Alloc>
+    const T& forward_list<T, Alloc>::front() const
+    {
+        return static_cast<const Node*>(head.next)->data;
+    }
+
+    template <class T, class Alloc>
+    T& forward_list<T, Alloc>::back()
+    {
+        return value(tail);
+    }
+
+    template <class T, class Alloc>
+    const T& forward_list<T, Alloc>::back() const
+    {
+        return static_cast<const Node*>(tail)->data;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::before_begin()
+    {
+        iterator it;
+        it.ptr = &head;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::const_iterator forward_list<T, Alloc>::cbefore_begin() const
+    {
+        const_iterator it;
+        it.ptr = &head;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::begin()
+    {
+        iterator it;
+        it.ptr = head.next;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::end()
+    {
+        return iterator();
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::const_iterator forward_list<T, Alloc>::cbegin() const
+    {
+        const_iterator it;
+        it.ptr = head.next;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::const_iterator forward_list<T, Alloc>::cend() const
+    {
+        return const_iterator();
+    }
+
+    template <class T, class Alloc>
+    bool forward_list<T, Alloc>::empty() const
+    {
+        return head.next == nullptr;
+    }
+
+    template <class T, class Alloc>
+    size_t forward_list<T, Alloc>::max_size() const
+    {
+        return node_traits::max_size(allocator);
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::clear()
+    {
+        destroy_chain(head.next);
+        head.next = nullptr;
+        tail = &head;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::insert_after(const_iterator pos, const T& value)
+    {
+        return emplace_after(pos, value);
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::insert_after(const_iterator pos, T&& value)
+    {
+        return emplace_after(pos, std::move(value));
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator
+    forward_list<T, Alloc>::insert_after(const_iterator pos, size_t count, const T& value)
+    {
+        iterator it;
+        it.ptr = const_cast<BaseNode*>(pos.ptr);
+        for (; count > 0; --count) {
+            it = emplace_after(it, value);
+        }
+        return it;
+    }
+
+    template <class T, class Alloc>
+    template <class InputIt, class>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::insert_after(const_iterator pos, InputIt first, InputIt last)
+    {
+        // новые элементы собираются в отдельную цепочку и включаются целиком: при исключении список не меняется
+        BaseNode *prev = const_cast<BaseNode*>(pos.ptr);
+        iterator it;
+        it.ptr = prev;
+        if (first == last) {
+            return it;
+        }
+        BaseNode chain;
+        BaseNode *chain_tail = &chain;
+        try {
+            for (; first != last; ++first) {
+                chain_tail->next = create_node(nullptr, *first);
+                chain_tail = chain_tail->next;
+            }
+        } catch (...) {
+            destroy_chain(chain.next);
+            throw;
+        }
+        chain_tail->next = prev->next;
+        prev->next = chain.next;
+        if (tail == prev) {
+            tail = chain_tail;
+        }
+        it.ptr = chain_tail;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::emplace_after(const_iterator pos, Args&&... args)
+    {
+        BaseNode *prev = const_cast<BaseNode*>(pos.ptr);
+        prev->next = create_node(prev->next, std::forward<Args>(args)...);
+        if (tail == prev) {
+            tail = prev->next;
+        }
+        iterator it;
+        it.ptr = prev->next;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator forward_list<T, Alloc>::erase_after(const_iterator pos)
+    {
+        BaseNode *prev = const_cast<BaseNode*>(pos.ptr);
+        Node *node = static_cast<Node*>(prev->next);
+        prev->next = node->next;
+        if (tail == node) {
+            tail = prev;
+        }
+        node_traits::destroy(allocator, node);
+        node_traits::deallocate(allocator, node, 1);
+        iterator it;
+        it.ptr = prev->next;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    typename forward_list<T, Alloc>::iterator
+    forward_list<T, Alloc>::erase_after(const_iterator first, const_iterator last)
+    {
+        BaseNode *prev = const_cast<BaseNode*>(first.ptr);
+        BaseNode *stop = const_cast<BaseNode*>(last.ptr);
+        if (prev->next != stop) {
+            // отрезаем (first, last) в отдельную цепочку и уничтожаем ее одной операцией
+            BaseNode *chain = prev->next;
+            BaseNode *chain_last = chain;
+            while (chain_last->next != stop) {
+                chain_last = chain_last->next;
+            }
+            chain_last->next = nullptr;
+            prev->next = stop;
+            if (stop == nullptr) {
+                tail = prev;
+            }
+            destroy_chain(chain);
+        }
+        iterator it;
+        it.ptr = stop;
+        return it;
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::push_front(const T& value)
+    {
+        emplace_after(cbefore_begin(), value);
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::push_front(T&& value)
+    {
+        emplace_after(cbefore_begin(), std::move(value));
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void forward_list<T, Alloc>::emplace_front(Args&&... args)
+    {
+        emplace_after(cbefore_begin(), std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::pop_front()
+    {
+        erase_after(cbefore_begin());
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void forward_list<T, Alloc>::emplace_back(Args&&... args)
+    {
+        const_iterator pos;
+        pos.ptr = tail;
+        emplace_after(pos, std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::swap(forward_list& other)
+    {
+        std::swap(head.next, other.head.next);
+        std::swap(tail, other.tail);
+        // у пустого списка последний элемент - собственная граница
+        if (head.next == nullptr) {
+            tail = &head;
+        }
+        if (other.head.next == nullptr) {
+            other.tail = &other.head;
+        }
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator, other.allocator);
+        }
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::splice_after(const_iterator pos, forward_list& other)
+    {
+        if (other.empty()) {
+            return;
+        }
+        BaseNode *prev = const_cast<BaseNode*>(pos.ptr);
+        other.tail->next = prev->next;
+        prev->next = other.head.next;
+        if (tail == prev) {
+            tail = other.tail;
+        }
+        other.head.next = nullptr;
+        other.tail = &other.head;
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::splice_after(const_iterator pos, forward_list& other, const_iterator it)
+    {
+        BaseNode *prev = const_cast<BaseNode*>(pos.ptr);
+        BaseNode *before = const_cast<BaseNode*>(it.ptr);
+        BaseNode *node = before->next;
+        if (node == nullptr || prev == before || prev == node) {
+            return;
+        }
+        before->next = node->next;
+        if (other.tail == node) {
+            other.tail = before;
+        }
+        node->next = prev->next;
+        prev->next = node;
+        if (tail == prev) {
+            tail = node;
+        }
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::splice_after(const_iterator pos, forward_list& other,
+                                              const_iterator first, const_iterator last)
+    {
+        BaseNode *prev = const_cast<BaseNode*>(pos.ptr);
+        BaseNode *before = const_cast<BaseNode*>(first.ptr);
+        BaseNode *stop = const_cast<BaseNode*>(last.ptr);
+        if (before == prev || before->next == stop) {
+            return;
+        }
+        BaseNode *chain = before->next;
+        BaseNode *chain_last = chain;
+        while (chain_last->next != stop) {
+            chain_last = chain_last->next;
+        }
+        before->next = stop;
+        if (other.tail == chain_last) {
+            other.tail = before;
+        }
+        chain_last->next = prev->next;
+        prev->next = chain;
+        if (tail == prev) {
+            tail = chain_last;
+        }
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::merge(forward_list& other)
+    {
+        merge(other, std::less<T>());
+    }
+
+    template <class T, class Alloc>
+    template <class Compare>
+    void forward_list<T, Alloc>::merge(forward_list& other, Compare comp)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        // последним станет последний элемент того списка, элементы которого закончатся позже
+        BaseNode *last = (!empty() && comp(value(other.tail), value(tail))) ? tail : other.tail;
+        auto less = [&comp](BaseNode* a, BaseNode* b) { return comp(value(a), value(b)); };
+        try {
+            merge_chains(head.next, other.head.next, less);
+        }
+        catch (...) {
+            // все элементы уже в этом списке, в неопределенном порядке
+            tail = last_of(head.next);
+            other.tail = &other.head;
+            throw;
+        }
+        tail = last;
+        other.tail = &other.head;
+    }
+
+    template <class T, class Alloc>
+    size_t forward_list<T, Alloc>::remove(const T& value)
+    {
+        // value может быть ссылкой на элемент списка: сравниваем с копией
+        T copy = value;
+        return remove_if([&copy](const T& x) { return x == copy; });
+    }
+
+    template <class T, class Alloc>
+    template <class UnaryPredicate>
+    size_t forward_list<T, Alloc>::remove_if(UnaryPredicate pred)
+    {
+        // удаляемые элементы собираются в цепочку и уничтожаются одной операцией после обхода
+        BaseNode removed;
+        BaseNode *removed_last = &removed;
+        size_t count = 0;
+        BaseNode *prev = &head;
+        try {
+            while (prev->next != nullptr) {
+                BaseNode *node = prev->next;
+                if (pred(value(node))) {
+                    prev->next = node->next;
+                    removed_last->next = node;
+                    removed_last = node;
+                    ++count;
+                }
+                else {
+                    prev = node;
+                }
+            }
+        }
+        catch (...) {
+            // уже исключенные элементы удаляются и при исключении из pred; tail не меняется:
+            // последний элемент еще не проверен, иначе обход бы уже закончился
+            removed_last->next = nullptr;
+            destroy_chain(removed.next);
+            throw;
+        }
+        removed_last->next = nullptr;
+        tail = prev;
+        destroy_chain(removed.next);
+        return count;
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::reverse() noexcept
+    {
+        BaseNode *node = head.next;
+        tail = (node != nullptr) ? node : &head;
+        BaseNode *reversed = nullptr;
+        while (node != nullptr) {
+            BaseNode *next = node->next;
+            node->next = reversed;
+            reversed = node;
+            node = next;
+        }
+        head.next = reversed;
+    }
+
+    template <class T, class Alloc>
+    size_t forward_list<T, Alloc>::unique()
+    {
+        return unique(std::equal_to<T>());
+    }
+
+    template <class T, class Alloc>
+    template <class BinaryPredicate>
+    size_t forward_list<T, Alloc>::unique(BinaryPredicate pred)
+    {
+        if (empty()) {
+            return 0;
+        }
+        BaseNode removed;
+        BaseNode *removed_last = &removed;
+        size_t count = 0;
+        BaseNode *kept = head.next;
+        try {
+            while (kept->next != nullptr) {
+                BaseNode *node = kept->next;
+                if (pred(value(kept), value(node))) {
+                    kept->next = node->next;
+                    removed_last->next = node;
+                    removed_last = node;
+                    ++count;
+                }
+                else {
+                    kept = node;
+                }
+            }
+        }
+        catch (...) {
+            removed_last->next = nullptr;
+            destroy_chain(removed.next);
+            throw;
+        }
+        removed_last->next = nullptr;
+        tail = kept;
+        destroy_chain(removed.next);
+        return count;
+    }
+
+    template <class T, class Alloc>
+    void forward_list<T, Alloc>::sort()
+    {
+        sort(std::less<T>());
+    }
+
+    template <class T, class Alloc>
+    template <class Compare>
+    void forward_list<T, Alloc>::sort(Compare comp)
+    {
+        if (head.next == nullptr || head.next->next == nullptr) {
+            return;
+        }
+        auto less = [&comp](BaseNode* a, BaseNode* b) { return comp(value(a), value(b)); };
+        try {
+            sort_chain(head.next, less);
+        }
+        catch (...) {
+            tail = last_of(head.next);
+            throw;
+        }
+        tail = last_of(head.next);
+    }
+
+}  // namespace task
@@ -0,0 +1,729 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional> // для std::less, std::equal_to
+#include <iterator>
+#include <utility>
+#include "chain_sort.h"
+
+namespace task {
+
+// связи элемента интрузивного списка; в несвязанном состоянии next == prev == nullptr
+class list_hook_node {
+public:
+    list_hook_node *next = nullptr;
+    list_hook_node *prev = nullptr;
+};
+
+// крючок (hook), встраиваемый в объект: базовым классом или полем.
+// Копия объекта не наследует связи оригинала. AutoUnlink = true - безопасный режим: при
+// уничтожении объекта крючок сам удаляет его из списка. Список с такими крючками
+// не знает, когда элемент исчез, поэтому его size() работает за O(n)
+template <bool AutoUnlink>
+class basic_list_hook : public list_hook_node {
+public:
+    static constexpr bool auto_unlink = AutoUnlink;
+
+    basic_list_hook() noexcept = default;
+    basic_list_hook(const basic_list_hook&) noexcept : list_hook_node() {}
+    basic_list_hook& operator=(const basic_list_hook&) noexcept { return *this; }
+    ~basic_list_hook() {
+        if (AutoUnlink) {
+            unlink();
+        }
+    }
+
+    bool is_linked() const noexcept { return next != nullptr; }
+
+    // удаление объекта из списка, в котором он находится, без доступа к самому списку
+    void unlink() noexcept {
+        if (is_linked()) {
+            next->prev = prev;
+            prev->next = next;
+            next = prev = nullptr;
+        }
+    }
+};
+
+using list_hook = basic_list_hook<false>;
+using auto_unlink_list_hook = basic_list_hook<true>;
+
+// способ найти крючок в объекте: T унаследован от крючка
+template <class T, class HookType = list_hook>
+struct base_hook {
+    using hook_type = HookType;
+    static hook_type* to_hook(T* value) noexcept { return static_cast<hook_type*>(value); }
+    static T* to_value(list_hook_node* node) noexcept { return static_cast<T*>(static_cast<hook_type*>(node)); }
+};
+
+// способ найти крючок в объекте: крючок - поле Member объекта T
+template <class T, class HookType, HookType T::* Member>
+struct member_hook {
+    using hook_type = HookType;
+    static hook_type* to_hook(T* value) noexcept {
+        hook_type *hook = &(value->*Member);
+        if (offset_.load(std::memory_order_relaxed) < 0) {
+            offset_.store(reinterpret_cast<char*>(hook) - reinterpret_cast<char*>(value), std::memory_order_relaxed);
+        }
+        return hook;
+    }
+    static T* to_value(list_hook_node* node) noexcept {
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(static_cast<hook_type*>(node)) -
+                                    offset_.load(std::memory_order_relaxed));
+    }
+private:
+    // смещение поля внутри T (-1 - еще не известно). Берется у настоящего объекта в to_hook: каждый
+    // элемент попадает в список через to_hook, поэтому к вызову to_value смещение уже записано
+    static std::atomic<std::ptrdiff_t> offset_;
+};
+
+template <class T, class HookType, HookType T::* Member>
+std::atomic<std::ptrdiff_t> member_hook<T, HookType, Member>::offset_(-1);
+
+// интрузивный список: связывает уже существующие объекты через встроенный в них крючок.
+// Список не владеет объектами, не выделяет память и не копирует значения; объект может
+// находиться не более чем в одном списке на каждый свой крючок.
+// Удаление из списка (erase, pop, clear, remove_if, unique) только отсоединяет объекты
+template <class T, class Hook = base_hook<T>>
+class intrusive_list {
+private:
+    using hook_type = typename Hook::hook_type;
+    static constexpr bool constant_time_size = !hook_type::auto_unlink;
+
+    list_hook_node head; // граница списка, всегда связана сама с собой или с элементами
+    size_t size_; // количество элементов, если constant_time_size
+
+    static T& value(list_hook_node* node) { return *Hook::to_value(node); }
+    static list_hook_node* node_of(T& value) { return Hook::to_hook(&value); }
+    // отсоединение одного узла с переводом крючка в несвязанное состояние
+    static void unlink_node(list_hook_node* node) noexcept;
+    // перенос узлов [first, last) перед pos
+    static void transfer(list_hook_node* pos, list_hook_node* first, list_hook_node* last) noexcept;
+
+    // восстановление prev и границ списка после работы с цепочкой по next
+    void restore_links(list_hook_node* chain) noexcept;
+
+public:
+    class const_iterator;
+
+    class iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        iterator() : ptr(nullptr) {}
+
+        iterator& operator++() {
+            ptr = ptr->next;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator it = *this;
+            ptr = ptr->next;
+            return it;
+        }
+        reference operator*() const { return value(ptr); }
+        pointer operator->() const { return &value(ptr); }
+        iterator& operator--() {
+            ptr = ptr->prev;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator it = *this;
+            ptr = ptr->prev;
+            return it;
+        }
+
+        bool operator==(iterator other) const { return ptr == other.ptr; }
+        bool operator!=(iterator other) const { return ptr != other.ptr; }
+
+        friend class intrusive_list;
+        friend class const_iterator;
+    private:
+        explicit iterator(list_hook_node* node) : ptr(node) {}
+        list_hook_node *ptr;
+    };
+
+    class const_iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() : ptr(nullptr) {}
+        const_iterator(const iterator& other) : ptr(other.ptr) {}
+
+        const_iterator& operator++() {
+            ptr = ptr->next;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ptr = ptr->next;
+            return it;
+        }
+        reference operator*() const { return value(ptr); }
+        pointer operator->() const { return &value(ptr); }
+        const_iterator& operator--() {
+            ptr = ptr->prev;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator it = *this;
+            ptr = ptr->prev;
+            return it;
+        }
+
+        bool operator==(const_iterator other) const { return ptr == other.ptr; }
+        bool operator!=(const_iterator other) const { return ptr != other.ptr; }
+
+        friend class intrusive_list;
+    private:
+        explicit const_iterator(list_hook_node* node) : ptr(node) {}
+        list_hook_node *ptr; // узлы принадлежат объектам пользователя, константность задается разыменованием
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+
+    intrusive_list() noexcept;
+    ~intrusive_list();
+
+    intrusive_list(const intrusive_list&) = delete;
+    intrusive_list& operator=(const intrusive_list&) = delete;
+    intrusive_list(intrusive_list&& other) noexcept;
+    intrusive_list& operator=(intrusive_list&& other) noexcept;
+
+
+    T& front();
+    const T& front() const;
+
+    T& back();
+    const T& back() const;
+
+
+    iterator begin();
+    iterator end();
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+    // итератор на объект, который находится в этом списке, за O(1)
+    iterator iterator_to(T& value);
+    const_iterator iterator_to(const T& value) const;
+
+
+    bool empty() const;
+    size_t size() const;
+    void clear() noexcept;
+
+    iterator insert(const_iterator pos, T& value);
+    template <class InputIt>
+    void insert(const_iterator pos, InputIt first, InputIt last);
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+    // удаление объекта из списка по ссылке на него, за O(1)
+    void erase(T& value);
+
+    void push_back(T& value);
+    void pop_back();
+
+    void push_front(T& value);
+    void pop_front();
+
+    void swap(intrusive_list& other) noexcept;
+
+
+    void merge(intrusive_list& other);
+    template <class Compare>
+    void merge(intrusive_list& other, Compare comp);
+    void splice(const_iterator pos, intrusive_list& other);
+    void splice(const_iterator pos, intrusive_list& other, const_iterator it);
+    void splice(const_iterator pos, intrusive_list& other, const_iterator first, const_iterator last);
+    size_t remove(const T& value);
+    template <class UnaryPredicate>
+    size_t remove_if(UnaryPredicate pred);
+    void reverse() noexcept;
+    size_t unique();
+    template <class BinaryPredicate>
+    size_t unique(BinaryPredicate pred);
+    void sort();
+    template <class Compare>
+    void sort(Compare comp);
+};
+
+    // служебные функции
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::unlink_node(list_hook_node* node) noexcept
+    {
+        node->next->prev = node->prev;
+        node->prev->next = node->next;
+        node->next = node->prev = nullptr;
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::transfer(list_hook_node* pos, list_hook_node* first, list_hook_node* last) noexcept
+    {
+        if (first == last || pos == last) {
+            return;
+        }
+        list_hook_node *tail = last->prev;
+        // вырезаем [first, last)
+        first->prev->next = last;
+        last->prev = first->prev;
+        // вставляем перед pos
+        first->prev = pos->prev;
+        tail->next = pos;
+        pos->prev->next = first;
+        pos->prev = tail;
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::restore_links(list_hook_node* chain) noexcept
+    {
+        list_hook_node *prev = &head;
+        for (list_hook_node *node = chain; node != nullptr; node = node->next) {
+            node->prev = prev;
+            prev->next = node;
+            prev = node;
+        }
+        prev->next = &head;
+        head.prev = prev;
+    }
+
+    // конструкторы
+
+    template <class T, class Hook>
+    intrusive_list<T, Hook>::intrusive_list() noexcept : size_(0)
+    {
+        head.next = head.prev = &head;
+    }
+
+    template <class T, class Hook>
+    intrusive_list<T, Hook>::~intrusive_list()
+    {
+        clear();
+    }
+
+    template <class T, class Hook>
+    intrusive_list<T, Hook>::intrusive_list(intrusive_list&& other) noexcept : intrusive_list()
+    {
+        swap(other);
+    }
+
+    template <class T, class Hook>
+    intrusive_list<T, Hook>& intrusive_list<T, Hook>::operator=(intrusive_list&& other) noexcept
+    {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    // доступ к элементам
+
+    template <class T, class Hook>
+    T& intrusive_list<T, Hook>::front()
+    {
+        return value(head.next);
+    }
+
+    template <class T, class Hook>
+    const T& intrusive_list<T, Hook>::front() const
+    {
+        return value(head.next);
+    }
+
+    template <class T, class Hook>
+    T& intrusive_list<T, Hook>::back()
+    {
+        return value(head.prev);
+    }
+
+    template <class T, class Hook>
+    const T& intrusive_list<T, Hook>::back() const
+    {
+        return value(head.prev);
+    }
+
+    // получение итераторов
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::begin()
+    {
+        return iterator(head.next);
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::end()
+    {
+        return iterator(&head);
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::cbegin() const
+    {
+        return const_iterator(head.next);
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::cend() const
+    {
+        return const_iterator(const_cast<list_hook_node*>(&head));
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::reverse_iterator intrusive_list<T, Hook>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::reverse_iterator intrusive_list<T, Hook>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::const_reverse_iterator intrusive_list<T, Hook>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::const_reverse_iterator intrusive_list<T, Hook>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::iterator_to(T& value)
+    {
+        return iterator(node_of(value));
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::const_iterator intrusive_list<T, Hook>::iterator_to(const T& value) const
+    {
+        return const_iterator(node_of(const_cast<T&>(value)));
+    }
+
+    // размер контейнера
+
+    template <class T, class Hook>
+    bool intrusive_list<T, Hook>::empty() const
+    {
+        return head.next == &head;
+    }
+
+    template <class T, class Hook>
+    size_t intrusive_list<T, Hook>::size() const
+    {
+        if (constant_time_size) {
+            return size_;
+        }
+        // элементы с auto_unlink_list_hook могли уйти из списка при своем уничтожении
+        return std::distance(cbegin(), cend());
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::clear() noexcept
+    {
+        // крючки переводятся в несвязанное состояние, чтобы объекты можно было снова вставить
+        list_hook_node *node = head.next;
+        while (node != &head) {
+            list_hook_node *next = node->next;
+            node->next = node->prev = nullptr;
+            node = next;
+        }
+        head.next = head.prev = &head;
+        size_ = 0;
+    }
+
+    // добавление элементов
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::insert(const_iterator pos, T& value)
+    {
+        list_hook_node *node = node_of(value);
+        list_hook_node *next = pos.ptr;
+        node->next = next;
+        node->prev = next->prev;
+        next->prev->next = node;
+        next->prev = node;
+        ++size_;
+        return iterator(node);
+    }
+
+    template <class T, class Hook>
+    template <class InputIt>
+    void intrusive_list<T, Hook>::insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        // first, last - диапазон объектов (не указателей), которые встраиваются в список
+        for (; first != last; ++first) {
+            insert(pos, *first);
+        }
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::push_back(T& value)
+    {
+        insert(cend(), value);
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::push_front(T& value)
+    {
+        insert(cbegin(), value);
+    }
+
+    // удаление элементов
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::erase(const_iterator pos)
+    {
+        list_hook_node *next = pos.ptr->next;
+        unlink_node(pos.ptr);
+        --size_;
+        return iterator(next);
+    }
+
+    template <class T, class Hook>
+    typename intrusive_list<T, Hook>::iterator intrusive_list<T, Hook>::erase(const_iterator first, const_iterator last)
+    {
+        while (first != last) {
+            first = erase(first);
+        }
+        return iterator(last.ptr);
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::erase(T& value)
+    {
+        unlink_node(node_of(value));
+        --size_;
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::pop_back()
+    {
+        if (!empty()) {
+            erase(const_iterator(head.prev));
+        }
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::pop_front()
+    {
+        if (!empty()) {
+            erase(const_iterator(head.next));
+        }
+    }
+
+    // обмен списков местами
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::swap(intrusive_list& other) noexcept
+    {
+        // элементы ссылаются на границу списка, поэтому переносим их через временный список
+        list_hook_node tmp;
+        tmp.next = tmp.prev = &tmp;
+        transfer(&tmp, head.next, &head);
+        transfer(&head, other.head.next, &other.head);
+        transfer(&other.head, tmp.next, &tmp);
+        std::swap(size_, other.size_);
+    }
+
+    // слияние, перемещение и удаление
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::merge(intrusive_list& other)
+    {
+        merge(other, std::less<T>());
+    }
+
+    template <class T, class Hook>
+    template <class Compare>
+    void intrusive_list<T, Hook>::merge(intrusive_list& other, Compare comp)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        list_hook_node *node = other.head.next;
+        list_hook_node *current = head.next;
+        while (node != &other.head) {
+            // равные элементы второго списка идут после элементов текущего
+            while (current != &head && !comp(value(node), value(current))) {
+                current = current->next;
+            }
+            list_hook_node *next = node->next;
+            node->prev = current->prev;
+            node->next = current;
+            current->prev->next = node;
+            current->prev = node;
+            node = next;
+        }
+        other.head.next = other.head.prev = &other.head;
+        size_ += other.size_;
+        other.size_ = 0;
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::splice(const_iterator pos, intrusive_list& other)
+    {
+        if (this != &other && !other.empty()) {
+            transfer(pos.ptr, other.head.next, &other.head);
+            size_ += other.size_;
+            other.size_ = 0;
+        }
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::splice(const_iterator pos, intrusive_list& other, const_iterator it)
+    {
+        transfer(pos.ptr, it.ptr, it.ptr->next);
+        if (this != &other && pos.ptr != it.ptr) {
+            ++size_;
+            --other.size_;
+        }
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::splice(const_iterator pos, intrusive_list& other,
+                                         const_iterator first, const_iterator last)
+    {
+        if (this != &other && constant_time_size) {
+            // размер перенесенного диапазона нужен только для size_
+            size_t count = std::distance(first, last);
+            size_ += count;
+            other.size_ -= count;
+        }
+        transfer(pos.ptr, first.ptr, last.ptr);
+    }
+
+    template <class T, class Hook>
+    size_t intrusive_list<T, Hook>::remove(const T& target)
+    {
+        size_t count = 0;
+        list_hook_node *self = nullptr; // сам target, если он элемент списка: отсоединяется последним
+        list_hook_node *node = head.next;
+        while (node != &head) {
+            list_hook_node *next = node->next;
+            if (&value(node) == &target) {
+                self = node;
+            }
+            else if (value(node) == target) {
+                unlink_node(node);
+                ++count;
+            }
+            node = next;
+        }
+        if (self != nullptr) {
+            unlink_node(self);
+            ++count;
+        }
+        size_ -= count;
+        return count;
+    }
+
+    template <class T, class Hook>
+    template <class UnaryPredicate>
+    size_t intrusive_list<T, Hook>::remove_if(UnaryPredicate pred)
+    {
+        size_t count = 0;
+        list_hook_node *node = head.next;
+        while (node != &head) {
+            list_hook_node *next = node->next;
+            if (pred(value(node))) {
+                unlink_node(node);
+                ++count;
+            }
+            node = next;
+        }
+        size_ -= count;
+        return count;
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::reverse() noexcept
+    {
+        list_hook_node *node = &head;
+        do {
+            std::swap(node->next, node->prev);
+            node = node->prev;
+        } while (node != &head);
+    }
+
+    template <class T, class Hook>
+    size_t intrusive_list<T, Hook>::unique()
+    {
+        return unique(std::equal_to<T>());
+    }
+
+    template <class T, class Hook>
+    template <class BinaryPredicate>
+    size_t intrusive_list<T, Hook>::unique(BinaryPredicate pred)
+    {
+        if (empty()) {
+            return 0;
+        }
+        size_t count = 0;
+        list_hook_node *kept = head.next;
+        list_hook_node *node = kept->next;
+        while (node != &head) {
+            list_hook_node *next = node->next;
+            if (pred(value(kept), value(node))) {
+                unlink_node(node);
+                ++count;
+            }
+            else {
+                kept = node;
+            }
+            node = next;
+        }
+        size_ -= count;
+        return count;
+    }
+
+    template <class T, class Hook>
+    void intrusive_list<T, Hook>::sort()
+    {
+        sort(std::less<T>());
+    }
+
+    // сортировка цепочки из chain_sort.h, общая с task::list: только перестановка указателей
+    template <class T, class Hook>
+    template <class Compare>
+    void intrusive_list<T, Hook>::sort(Compare comp)
+    {
+        if (head.next == &head || head.next->next == &head) {
+            return;
+        }
+        head.prev->next = nullptr;
+        list_hook_node *chain = head.next;
+        auto less = [&comp](list_hook_node* a, list_hook_node* b) { return comp(value(a), value(b)); };
+        try {
+            sort_chain(chain, less);
+        }
+        catch (...) {
+            restore_links(chain);
+            throw;
+        }
+        restore_links(chain);
+    }
+
+}  // namespace task
@@ -1,31 +1,212 @@
 #pragma once
+#include <algorithm> // для std::min
+#include <cstdint>
+#include <exception> // для std::exception_ptr
+#include <functional> // для std::less, std::equal_to
+#include <initializer_list>
 #include <iterator>
 #include <memory> // для allocator_traits
+#include <memory_resource>
+#include <optional>
+#include <stdexcept> // для std::out_of_range
+#include <thread>
+#include <type_traits>
+#include <utility> // для std::declval
+#include <vector>
+#include "chain_sort.h"
+#include "position_index.h"
 
 namespace task {
 
+// аллокатор может принять сразу пачку освобождаемых элементов:
+// alloc.deallocate_chain(first, count) получает count блоков по одному элементу,
+// связанных через первое слово-указатель каждого блока и завершенных nullptr
+template <class A, class = void>
+struct has_deallocate_chain : std::false_type {};
+
+template <class A>
+struct has_deallocate_chain<A, std::void_t<decltype(std::declval<A&>().deallocate_chain(
+    std::declval<typename std::allocator_traits<A>::pointer>(), size_t()))>> : std::true_type {};
+
+// значение T из args с передачей аллокатора, если T его использует (uses-allocator construction):
+// T(allocator_arg, alloc, args...), T(args..., alloc) или просто T(args...)
+template <class T, class Alloc, class... Args>
+T make_obj_using_allocator(const Alloc& alloc, Args&&... args)
+{
+    if constexpr (!std::uses_allocator<T, Alloc>::value) {
+        return T(std::forward<Args>(args)...);
+    }
+    else if constexpr (std::is_constructible<T, std::allocator_arg_t, const Alloc&, Args...>::value) {
+        return T(std::allocator_arg, alloc, std::forward<Args>(args)...);
+    }
+    else {
+        return T(std::forward<Args>(args)..., alloc);
+    }
+}
+
+template <class T, class Alloc>
+class mpsc_list_queue;
+
 template<class T, class Alloc = std::allocator<T>>
 class list {
+    // очередь создает элементы того же вида и передает их в список целой цепочкой
+    friend class mpsc_list_queue<T, Alloc>;
 
 private:
     // Node будет использоваться в iterator, поэтому объявляем private до public
-    class Node { // элемент списка
+    class BaseNode { // связи элемента списка, без данных
+    public:
+        BaseNode *next; // указатель на следующий элемент
+        BaseNode *prev; //указатель на предыдущий элемент
+        BaseNode() noexcept : next(this), prev(this) {};
+        BaseNode(BaseNode* n, BaseNode* p) noexcept : next(n), prev(p) {};
+    };
+    class Node : public BaseNode { // элемент списка
     public:
         T data; // данные
-        Node *next; // указатель на следующий элемент
-        Node *prev; //указатель на предыдущий элемент
-        // конструкторы
-        Node(Node* n, Node* p) : next(n), prev(p) {};
-        Node(const T& d, Node* n, Node* p) : data(d), next(n), prev(p) {}; // данные копируются
-        Node(T&& d, Node* n, Node* p) : data(std::move(d)), next(n), prev(p) {}; // данные перемещаются
+        // данные конструируются прямо в памяти элемента из переданных аргументов
+        template <class... Args>
+        Node(BaseNode* n, BaseNode* p, Args&&... args) : BaseNode(n, p), data(std::forward<Args>(args)...) {};
+
+        // конструирование с аллокатором: аллокаторы вроде std::pmr::polymorphic_allocator вызывают
+        // этот конструктор из construct, и данные, которые сами используют аллокатор
+        // (например, std::pmr::string), получают тот же ресурс памяти, что и список
+        using allocator_type = Alloc;
+        template <class... Args>
+        Node(std::allocator_arg_t, const Alloc& alloc, BaseNode* n, BaseNode* p, Args&&... args)
+            : BaseNode(n, p), data(make_obj_using_allocator<T>(alloc, std::forward<Args>(args)...)) {};
     };
     // аллокатор для типа Node
     using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<allocator_type>;
     allocator_type allocator;
-    Node *first; // первый элемент списка
-    Node *last; // последний элемент списка
+    // граница списка хранится внутри объекта: head.next - первый элемент, head.prev - последний,
+    // у пустого списка оба указателя ссылаются на сам head
+    BaseNode head;
     size_t size_; // размер списка
     
+    static T& value(BaseNode* node) { return static_cast<Node*>(node)->data; }
+    
+    // выделение памяти и конструирование элемента; если конструктор T бросит исключение, память освобождается
+    template <class... Args>
+    Node* create_node(BaseNode* next, BaseNode* prev, Args&&... args);
+    
+    // цепочка новых элементов, еще не включенных в список: связана через next и prev,
+    // у последнего элемента next == nullptr
+    struct Chain {
+        BaseNode *first = nullptr;
+        BaseNode *last = nullptr;
+        size_t size = 0;
+    };
+    template <class... Args>
+    void chain_emplace(Chain& chain, Args&&... args);
+    // уничтожение элементов цепочки, начиная с node, до nullptr; возвращает количество элементов
+    size_t destroy_chain(BaseNode* node) noexcept;
+    // включение всей цепочки в список перед pos одной операцией, возвращает первый вставленный элемент или pos
+    BaseNode* link_chain(BaseNode* pos, Chain& chain) noexcept;
+    // исключение элемента из списка и добавление его в начало цепочки удаляемых элементов
+    static void unlink_to_chain(BaseNode* node, BaseNode*& chain) noexcept;
+    // уничтожение цепочки исключенных из списка элементов с уменьшением size_; возвращает их количество
+    size_t erase_chain(BaseNode* removed) noexcept;
+    
+    // ограничение для шаблонных перегрузок, принимающих итераторы
+    template <class InputIt>
+    using RequireInputIter = std::enable_if_t<std::is_convertible<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>;
+    
+    // перенос всех элементов from в пустой to
+    static void take_nodes(BaseNode& to, BaseNode& from) noexcept;
+    // перенос всех элементов other вместе с индексом в пустой список с равным аллокатором;
+    // ссылки на блоки compact() переносит вызывающий
+    void steal(list& other) noexcept;
+    // присваивание значений [first, last) существующим элементам, создание недостающих и удаление лишних
+    template <class InputIt>
+    void assign_elements(InputIt first, InputIt last);
+    
+    // минимальная длина части в parallel_sort: меньшие списки сортируются в одном потоке
+    static constexpr size_t PARALLEL_SORT_MIN_PART = 1 << 14;
+    // замыкание отсортированной цепочки обратно в список: восстановление prev и границ
+    void restore_links(BaseNode* chain) noexcept;
+    // минимальная длина части в parallel_for_each на один поток
+    static constexpr size_t PARALLEL_MIN_PART = 1 << 12;
+    // длина отрезка parallel_transform_reduce: разбиение не зависит от числа потоков
+    static constexpr size_t PARALLEL_REDUCE_BLOCK = 1 << 12;
+    // начала отрезков по block элементов (последний может быть короче): по индексу позиций,
+    // если он включен, иначе одним проходом по списку
+    std::vector<const BaseNode*> split_points(size_t block) const;
+    // вызов task(i) для i = first, first + step, ... < last: первый - в вызывающем потоке, остальные -
+    // каждый в своем. Если поток не запустился, его задача выполняется в вызывающем потоке.
+    // Исключения задач перехватываются; после завершения всех потоков пробрасывается первое по i
+    template <class Task>
+    static void run_parallel(size_t first, size_t last, size_t step, Task& task);
+    
+    // упорядоченная серия элементов для адаптивной сортировки: цепочка по next от head до tail
+    struct Run {
+        BaseNode *head;
+        BaseNode *tail;
+        size_t size;
+    };
+    // выделение очередной серии начиная с node; убывающая серия разворачивается.
+    // При исключении из comp все элементы снова в цепочке node
+    template <class Compare>
+    static Run take_run(BaseNode*& node, Compare& comp);
+    // слияние соседних серий (a раньше b) в a с переносом целых участков за одну перестановку указателей;
+    // b становится пустой. При исключении из comp все элементы остаются в a в неопределенном порядке
+    template <class Compare>
+    static void merge_runs(Run& a, Run& b, Compare& comp);
+    
+    // непрерывный блок элементов, созданный compact(): элементы блока не освобождаются по одному,
+    // блок освобождается целиком, когда на него не остается ссылок
+    struct Arena {
+        Node *nodes; // элементы блока
+        size_t capacity; // количество элементов в блоке
+        size_t refs; // живые элементы блока + списки, в которых они могут находиться
+    };
+    using arena_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Arena>;
+    using arena_traits = std::allocator_traits<arena_allocator_type>;
+    // блоки, элементы которых могут находиться в этом списке, по возрастанию адреса элементов блока;
+    // обычно пусто или один блок
+    using arena_vector = std::vector<Arena*, typename std::allocator_traits<Alloc>::template rebind_alloc<Arena*>>;
+    arena_vector arenas;
+    size_t churn_; // количество созданных и уничтоженных элементов с последней проверки локальности
+    double compact_threshold_; // порог address_jump_score() для автоматического compact()
+    static constexpr double AUTO_COMPACT_OFF = 2; // больше любого значения address_jump_score()
+    static constexpr size_t AUTO_COMPACT_MIN_CHURN = 1 << 10;
+    
+    // блок, которому принадлежит элемент, или nullptr для отдельно выделенного элемента; O(log arenas.size())
+    Arena* find_arena(const BaseNode* node) const noexcept;
+    // место блока в упорядоченном arenas, проверка наличия и добавление (память зарезервирована заранее)
+    typename arena_vector::const_iterator arena_position(const Arena* arena) const noexcept;
+    bool has_arena(const Arena* arena) const noexcept;
+    void insert_arena(Arena* arena) noexcept;
+    // уничтожение одного элемента, уже исключенного из списка
+    void free_node(Node* node) noexcept;
+    // отказ от ссылок списка на все блоки; блоки без ссылок освобождаются
+    void release_arenas() noexcept;
+    // перед переносом всех элементов other в этот список: ссылки other на блоки переходят к этому списку
+    void adopt_arenas(list& other);
+    // перед переносом части элементов other: этот список тоже ссылается на блоки other
+    void share_arenas(const list& other);
+    // резервирование места под ссылки на блоки other, которых еще нет у этого списка
+    void reserve_arenas(const list& other);
+    // замена arenas вместе с аллокатором вектора: присваивание и swap вектора переносят его аллокатор
+    // только по собственным propagate_on_* и не должны оставлять реестр на прежнем аллокаторе списка
+    void replace_arenas(arena_vector&& source) noexcept;
+    
+    // необязательный индекс позиций (enable_index), nullptr - индекс выключен
+    using index_type = position_index<Alloc>;
+    using index_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<index_type>;
+    index_type *index_;
+    static const void* next_of(const void* node) { return static_cast<const BaseNode*>(node)->next; }
+    // обновление индекса после включения в список count элементов цепочки, начиная с first
+    void index_linked(BaseNode* first, size_t count) noexcept;
+    // обновление индекса перед исключением из списка элементов [first, last)
+    void index_unlinking(BaseNode* first, BaseNode* last) noexcept;
+    // после перестановки элементов индекс перестраивается при следующем запросе
+    void index_invalidate() noexcept;
+    // индекс, перестроенный при необходимости, или nullptr
+    index_type* ready_index() const;
+    
 public:
     class iterator {
     public:
@@ -51,7 +232,7 @@ public:
 
         friend class list; // делаем класс list дружественным, чтобы использовать ptr из list
     private:
-        Node *ptr; // указатель на элемент списка
+        BaseNode *ptr; // указатель на элемент списка
     };
 
     class const_iterator {
@@ -79,24 +260,32 @@ public:
         bool operator!=(const_iterator other) const;
         friend class list;
     private:
-        const Node *ptr;
+        const BaseNode *ptr;
     };
 
     using reverse_iterator = std::reverse_iterator<iterator>;
     using const_reverse_iterator = std::reverse_iterator<const_iterator>;
 
 
-    list();
-    explicit list(const Alloc& alloc);
+    list() noexcept(noexcept(Alloc()));
+    explicit list(const Alloc& alloc) noexcept;
     list(size_t count, const T& value, const Alloc& alloc = Alloc());
     explicit list(size_t count, const Alloc& alloc = Alloc());
 
     ~list();
 
+    // копия получает аллокатор select_on_container_copy_construction(other.get_allocator())
     list(const list& other);
-    list(list&& other);
+    list(const list& other, const Alloc& alloc);
+    list(list&& other) noexcept;
+    // при alloc != other.get_allocator() элементы перемещаются по одному
+    list(list&& other, const Alloc& alloc);
+    // аллокатор заменяется по propagate_on_container_copy_assignment
     list& operator=(const list& other);
-    list& operator=(list&& other);
+    // аллокатор заменяется по propagate_on_container_move_assignment; если он не заменяется и
+    // аллокаторы не равны, элементы other перемещаются по одному в уже существующие и новые элементы
+    list& operator=(list&& other) noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                                           std::allocator_traits<Alloc>::is_always_equal::value);
 
     Alloc get_allocator() const;
 
@@ -129,6 +318,9 @@ public:
     iterator insert(const_iterator pos, const T& value);
     iterator insert(const_iterator pos, T&& value);
     iterator insert(const_iterator pos, size_t count, const T& value);
+    template <class InputIt, class = RequireInputIter<InputIt>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+    iterator insert(const_iterator pos, std::initializer_list<T> ilist);
 
     iterator erase(const_iterator pos);
     iterator erase(const_iterator first, const_iterator last);
@@ -152,16 +344,106 @@ public:
     void emplace_front(Args&&... args);
 
     void resize(size_t count);
+    // аллокаторы обмениваются по propagate_on_container_swap; без него аллокаторы
+    // должны быть равны (иначе поведение не определено, как у std::list)
     void swap(list& other);
 
 
     void merge(list& other);
+    template <class Compare>
+    void merge(list& other, Compare comp);
     void splice(const_iterator pos, list& other);
-    void remove(const T& value);
+    // перенос одного элемента it из other (или из этого же списка) перед pos, O(1)
+    void splice(const_iterator pos, list& other, const_iterator it);
+    // перенос элементов [first, last) из other перед pos: O(1) внутри одного списка,
+    // O(last - first) между разными списками (нужен размер диапазона); pos не должен лежать в диапазоне
+    void splice(const_iterator pos, list& other, const_iterator first, const_iterator last);
+    size_t remove(const T& value);
+    template <class UnaryPredicate>
+    size_t remove_if(UnaryPredicate pred);
     void reverse();
-    void unique();
+    size_t unique();
+    template <class BinaryPredicate>
+    size_t unique(BinaryPredicate pred);
     void sort();
+    template <class Compare>
+    void sort(Compare comp);
+    // адаптивная (естественная) сортировка слиянием: использует уже упорядоченные участки,
+    // на отсортированных и обратно отсортированных данных работает за O(n)
+    void adaptive_sort();
+    template <class Compare>
+    void adaptive_sort(Compare comp);
+    // устойчивая поразрядная сортировка по целочисленному ключу key(element), младшие разряды первыми;
+    // элементы не перемещаются, используется только таблица корзин на стеке
+    void radix_sort();
+    template <class KeyFn>
+    void radix_sort(KeyFn key);
+    // устойчивая сортировка слиянием в thread_count потоках; компаратор вызывается одновременно
+    // из разных потоков (у каждого своя копия). Исключение из компаратора пробрасывается вызывающему
+    // после завершения всех потоков, элементы при этом остаются в списке в неопределенном порядке
+    void parallel_sort(size_t thread_count = std::thread::hardware_concurrency());
+    template <class Compare>
+    void parallel_sort(Compare comp, size_t thread_count = std::thread::hardware_concurrency());
+    // вызов f для каждого элемента в thread_count потоках: список делится на отрезки почти равной длины,
+    // каждый поток обходит свой отрезок своей копией f. Начала отрезков берутся из индекса позиций
+    // (enable_index), без него - одним предварительным проходом. Порядок вызовов между отрезками не определен;
+    // исключение из f пробрасывается вызывающему после завершения всех потоков (при нескольких - из
+    // самого раннего отрезка), часть элементов к этому моменту может быть уже обработана
+    template <class UnaryFunction>
+    void parallel_for_each(UnaryFunction f, size_t thread_count = std::thread::hardware_concurrency());
+    // reduce(init, transform(x)) по всем элементам в thread_count потоках. Список делится на отрезки
+    // фиксированной длины, внутри отрезка значения сворачиваются слева направо, затем результаты отрезков
+    // сворачиваются с init в порядке списка. Разбиение и порядок не зависят от thread_count, поэтому
+    // результат (в том числе с плавающей точкой) одинаков при любом числе потоков;
+    // reduce должна быть ассоциативной, коммутативность не требуется; исключения - как в parallel_for_each
+    template <class R, class BinaryOp, class UnaryOp>
+    R parallel_transform_reduce(R init, BinaryOp reduce, UnaryOp transform,
+                                size_t thread_count = std::thread::hardware_concurrency()) const;
+    
+    // перенос элементов в один непрерывный блок памяти в порядке обхода, с освобождением старых элементов.
+    // Все итераторы (кроме end()), указатели и ссылки на элементы становятся недействительными.
+    // Значения перемещаются (копируются, если перемещение может бросить исключение);
+    // при исключении список не меняется
+    void compact();
+    // оценка разбросанности элементов: доля переходов к следующему элементу, при которых его адрес
+    // не лежит сразу после текущего (в пределах кэш-линии); 0 - элементы подряд, 1 - все вразброс
+    double address_jump_score() const;
+    // порог для compact_if_scattered(): уплотнение, когда после size() созданных и уничтоженных
+    // элементов address_jump_score() > threshold; threshold > 1 выключает. Сам по себе порог
+    // ничего не перемещает: обычные операции никогда не уплотняют список и сохраняют итераторы
+    void auto_compact(double threshold);
+    // проверка локальности, если с прошлой проверки накопилось достаточно изменений, и compact(),
+    // если элементы разбросаны сильнее порога auto_compact. Вызывается явно там, где допустимо,
+    // что все итераторы и ссылки станут недействительными (например, между пакетами запросов);
+    // возвращает true, если список уплотнен. Ошибка compact() не выходит наружу: список остается как был
+    bool compact_if_scattered() noexcept;
+    
+    // индекс позиций: at, nth и index_of за O(log n) ценой дополнительной памяти на каждый элемент
+    // и O(log n) на каждую вставку и удаление. Индекс поддерживается вставками, удалениями и splice;
+    // после операций, переставляющих элементы (sort, merge, reverse, remove_if, unique, compact),
+    // он перестраивается за O(n) при следующем запросе (поэтому одновременные const-запросы из разных
+    // потоков нужно синхронизировать). Устройство элементов списка не меняется,
+    // без индекса at, nth и index_of работают за O(n)
+    void enable_index();
+    void disable_index() noexcept;
+    bool has_index() const;
+    // элемент на позиции n; при n >= size() бросает std::out_of_range
+    T& at(size_t n);
+    const T& at(size_t n) const;
+    // итератор на позицию n <= size()
+    iterator nth(size_t n);
+    const_iterator nth(size_t n) const;
+    // позиция элемента it (size() для end())
+    size_t index_of(const_iterator it) const;
 };
+
+namespace pmr {
+    // список на полиморфном аллокаторе: ресурс памяти задается при конструировании
+    // (например, std::pmr::monotonic_buffer_resource на время обработки одного запроса)
+    // и передается элементам, которые сами используют аллокатор
+    template <class T>
+    using list = task::list<T, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
     
     // iterator
     
@@ -196,12 +478,12 @@ public:
     
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator::reference list<T, Alloc>::iterator::operator*() const {
-        return ptr->data;
+        return static_cast<Node*>(ptr)->data;
     }
     
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator::pointer list<T, Alloc>::iterator::operator->() const {
-        return &(ptr->data);
+        return &(static_cast<Node*>(ptr)->data);
     }
     
     template <class T, class Alloc>
@@ -265,12 +547,12 @@ public:
     
     template <class T, class Alloc>
     typename list<T, Alloc>::const_iterator::reference list<T, Alloc>::const_iterator::operator*() const {
-        return ptr->data;
+        return static_cast<const Node*>(ptr)->data;
     }
     
     template <class T, class Alloc>
     typename list<T, Alloc>::const_iterator::pointer list<T, Alloc>::const_iterator::operator->() const {
-        return &(ptr->data);
+        return &(static_cast<const Node*>(ptr)->data);
     }
     
     template <class T, class Alloc>
@@ -281,7 +563,7 @@ public:
     
     template <class T, class Alloc>
     typename list<T, Alloc>::const_iterator list<T, Alloc>::const_iterator::operator--(int) {
-        iterator it = *this;
+        const_iterator it = *this;
         ptr = ptr->prev;
         return it;
     }
@@ -299,31 +581,37 @@ public:
     // list
     
     template <class T, class Alloc>
-    list<T, Alloc>::list() : size_(0)
+    void list<T, Alloc>::take_nodes(BaseNode& to, BaseNode& from) noexcept
     {
-        // выделяем память для первого и последнего элементов
-        // конструктор T для этих элементов не вызываем, данные они хранить не будут
-        first = allocator.allocate(1);
-        last = allocator.allocate(1);
-        first->prev = nullptr;
-        first->next = last;
-        last->prev = first;
-        last->next = nullptr;
+        if (from.next != &from) {
+            to.next = from.next;
+            to.prev = from.prev;
+            to.next->prev = &to;
+            to.prev->next = &to;
+            from.next = from.prev = &from;
+        }
     }
     
+    // конструкторы пустого списка не выделяют память: граница списка хранится в самом объекте
     template <class T, class Alloc>
-    list<T, Alloc>::list(const Alloc& alloc) : list<T, Alloc>()
+    list<T, Alloc>::list() noexcept(noexcept(Alloc()))
+        : allocator(), head(), size_(0), arenas(allocator), churn_(0), compact_threshold_(AUTO_COMPACT_OFF),
+          index_(nullptr)
+    {
+    }
+    
+    template <class T, class Alloc>
+    list<T, Alloc>::list(const Alloc& alloc) noexcept
+        : allocator(alloc), head(), size_(0), arenas(allocator), churn_(0), compact_threshold_(AUTO_COMPACT_OFF),
+          index_(nullptr)
     {
-        allocator = alloc;
     }
     
     template <class T, class Alloc>
     list<T, Alloc>::list(size_t count, const T& value, const Alloc& alloc) : list<T, Alloc>(alloc)
     {
         // заполняем список count значениями value
-        while (size_ < count) {
-            push_back(value);
-        }
+        insert(cend(), count, value);
     }
     
     template <class T, class Alloc>
@@ -336,58 +624,133 @@ public:
     template <class T, class Alloc>
     list<T, Alloc>::~list()
     {
-        // очищаем список и освобождаем память, занятую первым и последним элементом
         clear();
-        allocator.deallocate(first, 1);
-        allocator.deallocate(last, 1);
+        disable_index();
     }
     
     // конструктор копирования
     template <class T, class Alloc>
-    list<T, Alloc>::list(const list& other) : list<T, Alloc>()
+    list<T, Alloc>::list(const list& other)
+        : list<T, Alloc>(other, std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+    {
+    }
+    
+    template <class T, class Alloc>
+    list<T, Alloc>::list(const list& other, const Alloc& alloc) : list<T, Alloc>(alloc)
     {
-        for (const_iterator it = other.cbegin(); it != other.cend(); it++) {
-            push_back(*it);
+        insert(cend(), other.cbegin(), other.cend());
+        if (other.index_ != nullptr) {
+            enable_index();
         }
     }
     
     // конструктор перемещения
     template <class T, class Alloc>
-    list<T, Alloc>::list(list&& other) : list<T, Alloc>()
+    list<T, Alloc>::list(list&& other) noexcept
+        : allocator(std::move(other.allocator)), head(), size_(other.size_), arenas(std::move(other.arenas)),
+          churn_(0), compact_threshold_(other.compact_threshold_), index_(other.index_)
     {
         // перемещаем данные из второго списка в первый
-        first->next = other.first->next;
-        first->next->prev = first;
-        last->prev = other.last->prev;
-        last->prev->next = last;
+        take_nodes(head, other.head);
+        other.size_ = 0;
+        other.arenas.clear();
+        other.index_ = nullptr;
+    }
+    
+    template <class T, class Alloc>
+    list<T, Alloc>::list(list&& other, const Alloc& alloc) : list<T, Alloc>(alloc)
+    {
+        compact_threshold_ = other.compact_threshold_;
+        if (allocator == other.allocator) {
+            arenas.swap(other.arenas);
+            steal(other);
+            return;
+        }
+        // элементы other освобождаются только его аллокатором: переносим значения в новые элементы
+        insert(cend(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        if (other.index_ != nullptr) {
+            enable_index();
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::steal(list& other) noexcept
+    {
+        take_nodes(head, other.head);
         size_ = other.size_;
-        other.first->next = other.last;
-        other.last->prev = other.first;
         other.size_ = 0;
+        std::swap(index_, other.index_);
+    }
+    
+    template <class T, class Alloc>
+    template <class InputIt>
+    void list<T, Alloc>::assign_elements(InputIt first, InputIt last)
+    {
+        // присваиваем значения уже существующим элементам, память выделяем только для недостающих
+        // и освобождаем только лишний хвост
+        iterator dst = begin();
+        for (; dst != end() && first != last; ++dst, ++first) {
+            *dst = *first;
+        }
+        if (first == last) {
+            erase(dst, end());
+        }
+        else {
+            insert(cend(), first, last);
+        }
     }
     
     template <class T, class Alloc>
     list<T, Alloc>& list<T, Alloc>::operator=(const list& other)
     {
-        clear(); // предварительно очищаем список
-        for (const_iterator it = other.cbegin(); it != other.cend(); it++) {
-            push_back(*it);
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+            // элементы, блоки compact() и индекс должны освобождаться тем аллокатором, которым были выделены
+            if (allocator != other.allocator) {
+                bool indexed = index_ != nullptr;
+                clear();
+                disable_index();
+                allocator = other.allocator;
+                replace_arenas(arena_vector(allocator));
+                if (indexed) {
+                    enable_index();
+                }
+            }
+            else {
+                allocator = other.allocator;
+            }
         }
+        assign_elements(other.cbegin(), other.cend());
         return *this;
     }
     
     template <class T, class Alloc>
     list<T, Alloc>& list<T, Alloc>::operator=(list&& other)
+        noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                 std::allocator_traits<Alloc>::is_always_equal::value)
     {
-        clear(); // предварительно очищаем список
-        first->next = other.first->next;
-        first->next->prev = first;
-        last->prev = other.last->prev;
-        last->prev->next = last;
-        size_ = other.size_;
-        other.first->next = other.last;
-        other.last->prev = other.first;
-        other.size_ = 0;
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+            // свои элементы и индекс освобождаем старым аллокатором, затем забираем аллокатор other
+            clear();
+            disable_index();
+            allocator = std::move(other.allocator);
+            replace_arenas(std::move(other.arenas));
+            other.arenas.clear();
+            steal(other);
+        }
+        else if (allocator == other.allocator) {
+            clear(); // предварительно очищаем список
+            arenas.swap(other.arenas);
+            steal(other);
+        }
+        else {
+            assign_elements(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
         return *this;
     }
     
@@ -402,25 +765,25 @@ public:
     template <class T, class Alloc>
     T& list<T, Alloc>::front()
     {
-        return first->next->data;
+        return value(head.next);
     }
     
     template <class T, class Alloc>
     const T& list<T, Alloc>::front() const
     {
-        return first->next->data;
+        return static_cast<const Node*>(head.next)->data;
     }
     
     template <class T, class Alloc>
     T& list<T, Alloc>::back()
     {
-        return last->prev->data;
+        return value(head.prev);
     }
     
     template <class T, class Alloc>
     const T& list<T, Alloc>::back() const
     {
-        return last->prev->data;
+        return static_cast<const Node*>(head.prev)->data;
     }
     
     // получение итераторов
@@ -429,7 +792,7 @@ public:
     typename list<T, Alloc>::iterator list<T, Alloc>::begin()
     {
         iterator it;
-        it.ptr = first->next;
+        it.ptr = head.next;
         return it;
     }
     
@@ -437,7 +800,7 @@ public:
     typename list<T, Alloc>::iterator list<T, Alloc>::end()
     {
         iterator it;
-        it.ptr = last;
+        it.ptr = &head;
         return it;
     }
     
@@ -445,7 +808,7 @@ public:
     typename list<T, Alloc>::const_iterator list<T, Alloc>::cbegin() const
     {
         const_iterator it;
-        it.ptr = first->next;
+        it.ptr = head.next;
         return it;
     }
     
@@ -453,23 +816,21 @@ public:
     typename list<T, Alloc>::const_iterator list<T, Alloc>::cend() const
     {
         const_iterator it;
-        it.ptr = last;
+        it.ptr = &head;
         return it;
     }
     
     template <class T, class Alloc>
     typename task::list<T, Alloc>::reverse_iterator list<T, Alloc>::rbegin()
     {
-        reverse_iterator it;
-        it.ptr = last->prev;
+        reverse_iterator it(end());
         return it;
     }
     
     template <class T, class Alloc>
     typename list<T, Alloc>::reverse_iterator list<T, Alloc>::rend()
     {
-        reverse_iterator it;
-        it.ptr = first;
+        reverse_iterator it(begin());
         return it;
     }
     
@@ -502,7 +863,7 @@ public:
     template <class T, class Alloc>
     size_t list<T, Alloc>::max_size() const
     {
-        return allocator.max_size();
+        return node_traits::max_size(allocator);
     }
     
     // внесение изменений
@@ -511,20 +872,108 @@ public:
     template <class T, class Alloc>
     void list<T, Alloc>::clear()
     {
-        // удаляем все элементы
-        while (!empty()) {
-            pop_front();
+        // отсоединяем все элементы разом и уничтожаем их одним проходом
+        if (!empty()) {
+            head.prev->next = nullptr;
+            destroy_chain(head.next);
+            head.next = head.prev = &head;
+            size_ = 0;
+        }
+        release_arenas();
+        if (index_ != nullptr) {
+            index_->clear();
         }
     }
     
     // добавление элементов
     
+    template <class T, class Alloc>
+    template <class... Args>
+    typename list<T, Alloc>::Node* list<T, Alloc>::create_node(BaseNode* next, BaseNode* prev, Args&&... args)
+    {
+        Node *node = node_traits::allocate(allocator, 1);
+        try {
+            node_traits::construct(allocator, node, next, prev, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(allocator, node, 1);
+            throw;
+        }
+        ++churn_;
+        return node;
+    }
+    
+    template <class T, class Alloc>
+    template <class... Args>
+    void list<T, Alloc>::chain_emplace(Chain& chain, Args&&... args)
+    {
+        Node *node = create_node(nullptr, chain.last, std::forward<Args>(args)...);
+        if (chain.last != nullptr) {
+            chain.last->next = node;
+        }
+        else {
+            chain.first = node;
+        }
+        chain.last = node;
+        ++chain.size;
+    }
+    
+    template <class T, class Alloc>
+    size_t list<T, Alloc>::destroy_chain(BaseNode* node) noexcept
+    {
+        // next - первое поле элемента, поэтому после уничтожения данных цепочка
+        // уже имеет вид, который ожидает deallocate_chain
+        size_t count = 0;
+        if (!arenas.empty()) {
+            // среди элементов могут быть элементы блоков compact(): освобождаем по одному
+            while (node != nullptr) {
+                Node *to_del = static_cast<Node*>(node);
+                node = node->next;
+                free_node(to_del);
+                ++count;
+            }
+            return count;
+        }
+        
+        BaseNode *chain = node;
+        while (node != nullptr) {
+            Node *to_del = static_cast<Node*>(node);
+            node = node->next;
+            node_traits::destroy(allocator, to_del);
+            if constexpr (!has_deallocate_chain<allocator_type>::value) {
+                node_traits::deallocate(allocator, to_del, 1);
+            }
+            ++count;
+        }
+        if constexpr (has_deallocate_chain<allocator_type>::value) {
+            if (chain != nullptr) {
+                allocator.deallocate_chain(static_cast<Node*>(chain), count);
+            }
+        }
+        churn_ += count;
+        return count;
+    }
+    
+    template <class T, class Alloc>
+    typename list<T, Alloc>::BaseNode* list<T, Alloc>::link_chain(BaseNode* pos, Chain& chain) noexcept
+    {
+        if (chain.first == nullptr) {
+            return pos;
+        }
+        BaseNode *prev = pos->prev;
+        chain.first->prev = prev;
+        chain.last->next = pos;
+        prev->next = chain.first;
+        pos->prev = chain.last;
+        size_ += chain.size;
+        index_linked(chain.first, chain.size);
+        return chain.first;
+    }
+    
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator list<T, Alloc>::insert(const_iterator pos, const T& value)
     {
-        Node *prev = pos.ptr->prev; // элемент, после которого вставляем новый
-        Node *node = allocator.allocate(1); // новый элемент
-        allocator.construct(node, value, prev->next, prev);
+        BaseNode *prev = pos.ptr->prev; // элемент, после которого вставляем новый
+        Node *node = create_node(prev->next, prev, value); // новый элемент
         prev->next->prev = node;
         prev->next = node;
         
@@ -533,15 +982,15 @@ public:
         it.ptr = node;
         
         ++size_;
+        index_linked(node, 1);
         return it;
     }
     
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator list<T, Alloc>::insert(const_iterator pos, T&& value)
     {
-        Node *prev = pos.ptr->prev; // элемент, после которого вставляем новый
-        Node *node = allocator.allocate(1); // новый элемент
-        allocator.construct(node, std::move(value), prev->next, prev);
+        BaseNode *prev = pos.ptr->prev; // элемент, после которого вставляем новый
+        Node *node = create_node(prev->next, prev, std::move(value)); // новый элемент
         prev->next->prev = node;
         prev->next = node;
         
@@ -550,35 +999,68 @@ public:
         it.ptr = node;
         
         ++size_;
+        index_linked(node, 1);
         return it;
     }
     
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator list<T, Alloc>::insert(const_iterator pos, size_t count, const T& value)
     {
-        // добавляем нужное количество новых элементов
+        // сначала строим цепочку вне списка, затем вставляем ее целиком;
+        // при исключении список не меняется
+        Chain chain;
+        try {
+            for (size_t i = 0; i < count; ++i) {
+                chain_emplace(chain, value);
+            }
+        } catch (...) {
+            destroy_chain(chain.first);
+            throw;
+        }
         iterator it;
-        for (int i = 0; i < count; i++) {
-            it = insert(pos, value);
+        it.ptr = link_chain(const_cast<BaseNode*>(pos.ptr), chain);
+        return it;
+    }
+    
+    template <class T, class Alloc>
+    template <class InputIt, class>
+    typename list<T, Alloc>::iterator list<T, Alloc>::insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        Chain chain;
+        try {
+            for (; first != last; ++first) {
+                chain_emplace(chain, *first);
+            }
+        } catch (...) {
+            destroy_chain(chain.first);
+            throw;
         }
+        iterator it;
+        it.ptr = link_chain(const_cast<BaseNode*>(pos.ptr), chain);
         return it;
     }
     
+    template <class T, class Alloc>
+    typename list<T, Alloc>::iterator list<T, Alloc>::insert(const_iterator pos, std::initializer_list<T> ilist)
+    {
+        return insert(pos, ilist.begin(), ilist.end());
+    }
+    
     // удаление элементов
     
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator pos)
     {
-        Node *to_del = const_cast<Node*>(pos.ptr); // указатель на удаляемый элемент
+        Node *to_del = static_cast<Node*>(const_cast<BaseNode*>(pos.ptr)); // указатель на удаляемый элемент
         iterator it; // итератор на элемент, следующий за удаляемым
         it.ptr = to_del->next;
         
         // исключаем элемент из списка и уничтожаем
+        index_unlinking(to_del, to_del->next);
         it.ptr->prev = to_del->prev;
         to_del->prev->next = to_del->next;
         --size_;
-        allocator.destroy(to_del);
-        allocator.deallocate(to_del, 1);
+        free_node(to_del);
         
         return it;
     }
@@ -586,13 +1068,18 @@ public:
     template <class T, class Alloc>
     typename list<T, Alloc>::iterator list<T, Alloc>::erase(const_iterator first, const_iterator last)
     {
-        // удаляем элементы от first до last
-        const_iterator c_it = first;
-        while (c_it != last) {
-            c_it = erase(c_it);
-        }
         iterator it;
-        it.ptr = const_cast<Node*>(c_it.ptr);
+        it.ptr = const_cast<BaseNode*>(last.ptr);
+        if (first != last) {
+            // исключаем из списка весь диапазон за O(1), затем уничтожаем его одним проходом
+            BaseNode *from = const_cast<BaseNode*>(first.ptr);
+            BaseNode *prev = from->prev;
+            index_unlinking(from, it.ptr);
+            it.ptr->prev->next = nullptr;
+            prev->next = it.ptr;
+            it.ptr->prev = prev;
+            size_ -= destroy_chain(from);
+        }
         return it;
     }
     
@@ -601,19 +1088,19 @@ public:
     template <class T, class Alloc>
     void list<T, Alloc>::push_back(const T& value)
     {
-        Node *node = allocator.allocate(1);
-        allocator.construct(node, value, last, last->prev);
-        last->prev = last->prev->next = node;
+        Node *node = create_node(&head, head.prev, value);
+        head.prev = head.prev->next = node;
         ++size_;
+        index_linked(node, 1);
     }
     
     template <class T, class Alloc>
     void list<T, Alloc>::push_back(T&& value)
     {
-        Node *node = allocator.allocate(1);
-        allocator.construct(node, std::move(value), last, last->prev);
-        last->prev = last->prev->next = node;
+        Node *node = create_node(&head, head.prev, std::move(value));
+        head.prev = head.prev->next = node;
         ++size_;
+        index_linked(node, 1);
     }
     
     // удаление из конца списка
@@ -623,11 +1110,11 @@ public:
     {
         // только если список не пустой, исключаем и уничтожаем последний элемент
         if (!empty()) {
-            Node *node = last->prev;
+            Node *node = static_cast<Node*>(head.prev);
+            index_unlinking(node, node->next);
             node->prev->next = node->next;
             node->next->prev = node->prev;
-            allocator.destroy(node);
-            allocator.deallocate(node, 1);
+            free_node(node);
             --size_;
         }
     }
@@ -637,19 +1124,19 @@ public:
     template <class T, class Alloc>
     void list<T, Alloc>::push_front(const T& value)
     {
-        Node *node = allocator.allocate(1);
-        allocator.construct(node, value, first->next, first);
-        first->next = first->next->prev = node;
+        Node *node = create_node(head.next, &head, value);
+        head.next = head.next->prev = node;
         ++size_;
+        index_linked(node, 1);
     }
     
     template <class T, class Alloc>
     void list<T, Alloc>::push_front(T&& value)
     {
-        Node *node = allocator.allocate(1);
-        allocator.construct(node, std::move(value), first->next, first);
-        first->next = first->next->prev = node;
+        Node *node = create_node(head.next, &head, std::move(value));
+        head.next = head.next->prev = node;
         ++size_;
+        index_linked(node, 1);
     }
     
     template <class T, class Alloc>
@@ -657,11 +1144,11 @@ public:
     {
         // только если список не пустой, исключаем и уничтожаем первый элемент
         if (!empty()) {
-            Node *node = first->next;
+            Node *node = static_cast<Node*>(head.next);
+            index_unlinking(node, node->next);
             node->prev->next = node->next;
             node->next->prev = node->prev;
-            allocator.destroy(node);
-            allocator.deallocate(node, 1);
+            free_node(node);
             --size_;
         }
     }
@@ -672,16 +1159,10 @@ public:
     template <class... Args>
     typename list<T, Alloc>::iterator list<T, Alloc>::emplace(typename list<T, Alloc>::const_iterator pos, Args&&... args)
     {
-        Node *prev = pos.ptr->prev; // элемент, после которого вставляем новый
+        BaseNode *prev = pos.ptr->prev; // элемент, после которого вставляем новый
         
-        // создаем новый элемент
-        Alloc data_allocator; // для вызова конструктора T
-        Node *node = allocator.allocate(1); // память для элемента
-        T *data = data_allocator.allocate(1); // память для данных
-        data_allocator.construct(data, std::forward<Args>(args)...); // вызов конструктора
-        allocator.construct(node, std::move(*data), prev->next, prev); // вызов конструктора элемента
-        data_allocator.destroy(data);
-        data_allocator.deallocate(data, 1);
+        // T конструируется сразу в памяти элемента: одно выделение памяти, без промежуточных копий
+        Node *node = create_node(prev->next, prev, std::forward<Args>(args)...);
         
         // ставим элемент на нужную позицию
         prev->next->prev = node;
@@ -689,9 +1170,10 @@ public:
         
         // создаем итератор на вставленный элемент
         iterator it;
-        it.ptr = pos.ptr->prev;
+        it.ptr = node;
         
         ++size_;
+        index_linked(node, 1);
         return it;
     }
     
@@ -699,14 +1181,20 @@ public:
     template <class... Args>
     void list<T, Alloc>::emplace_back(Args&&... args)
     {
-        emplace(end(), std::forward<Args>(args)...);
+        Node *node = create_node(&head, head.prev, std::forward<Args>(args)...);
+        head.prev = head.prev->next = node;
+        ++size_;
+        index_linked(node, 1);
     }
     
     template <class T, class Alloc>
     template <class... Args>
     void list<T, Alloc>::emplace_front(Args&&... args)
     {
-        emplace(begin(), std::forward<Args>(args)...);
+        Node *node = create_node(head.next, &head, std::forward<Args>(args)...);
+        head.next = head.next->prev = node;
+        ++size_;
+        index_linked(node, 1);
     }
     
     // изменение размера списка
@@ -715,15 +1203,19 @@ public:
     {
         // добавление элементов, если новый размер больше
         while (size_ < count) {
-            Node *node = allocator.allocate(1);
-            allocator.construct(node, last, last->prev);
-            last->prev = last->prev->next = node;
+            Node *node = create_node(&head, head.prev);
+            head.prev = head.prev->next = node;
             ++size_;
+            index_linked(node, 1);
         }
         
-        //удаление элементов, если новый размер меньше
-        while (size_ > count) {
-            pop_back();
+        //удаление элементов, если новый размер меньше: находим начало лишнего хвоста и удаляем его целиком
+        if (size_ > count) {
+            const_iterator from = cend();
+            for (size_t i = count; i < size_; ++i) {
+                --from;
+            }
+            erase(from, cend());
         }
     }
     
@@ -731,32 +1223,54 @@ public:
     template <class T, class Alloc>
     void list<T, Alloc>::swap(list& other)
     {
-        //обмениваем первые и последние элементы и размеры
-        Node *node = first;
-        first = other.first;
-        other.first = node;
-        node = other.last;
-        other.last = last;
-        last = node;
+        //обмениваем цепочки элементов и размеры
+        BaseNode tmp;
+        take_nodes(tmp, head);
+        take_nodes(head, other.head);
+        take_nodes(other.head, tmp);
         size_t s = size_;
         size_ = other.size_;
         other.size_ = s;
+        std::swap(index_, other.index_);
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator, other.allocator);
+            arena_vector tmp(std::move(arenas));
+            replace_arenas(std::move(other.arenas));
+            other.replace_arenas(std::move(tmp));
+        }
+        else {
+            arenas.swap(other.arenas);
+        }
     }
     
     // добавление списка к текущему с сохранением упорядоченности
     template <class T, class Alloc>
     void list<T, Alloc>::merge(list& other)
     {
-        // только если второй список не пуст
-        if (!other.empty()) {
-            Node *node = other.first->next; // добавляемый элемент из второго списка
-            Node *current = first->next; // текущий элемент текущего списка
-            while (node != other.last) { // для всех элементов второго списка
-                while (current != last && node->data > current->data) { // находим позицию
+        merge(other, std::less<T>());
+    }
+    
+    template <class T, class Alloc>
+    template <class Compare>
+    void list<T, Alloc>::merge(list& other, Compare comp)
+    {
+        // только если второй список не пуст и не совпадает с текущим
+        if (this != &other && !other.empty()) {
+            adopt_arenas(other);
+            index_invalidate();
+            if (other.index_ != nullptr) {
+                other.index_->clear();
+            }
+            BaseNode *node = other.head.next; // добавляемый элемент из второго списка
+            BaseNode *current = head.next; // текущий элемент текущего списка
+            while (node != &other.head) { // для всех элементов второго списка
+                // находим позицию: равные элементы второго списка идут после элементов текущего
+                while (current != &head && !comp(value(node), value(current))) {
                     current = current->next;
                 }
                 // вставляем элемент (указатели без копирования данных)
-                Node *next = node->next;
+                BaseNode *next = node->next;
                 node->prev = current->prev;
                 node->next = current;
                 current->prev->next = node;
@@ -764,8 +1278,7 @@ public:
                 node = next;
             }
             // убираем перемещенные элементы из второго списка
-            other.first->next = other.last;
-            other.last->prev = other.first;
+            other.head.next = other.head.prev = &other.head;
             size_ += other.size_;
             other.size_ = 0;
         }
@@ -777,38 +1290,141 @@ public:
     {
         // если второй список не пуст, вставляем его между pos->prev и pos
         if (!other.empty()) {
-            Node *node = const_cast<Node*>(pos.ptr);
-            node->prev->next = other.first->next;
-            other.first->next->prev = node->prev;
-            node->prev = other.last->prev;
-            other.last->prev->next = node;
-            other.first->next = other.last;
-            other.last->prev = other.first;
+            adopt_arenas(other);
+            BaseNode *first = other.head.next;
+            size_t count = other.size_;
+            BaseNode *node = const_cast<BaseNode*>(pos.ptr);
+            node->prev->next = other.head.next;
+            other.head.next->prev = node->prev;
+            node->prev = other.head.prev;
+            other.head.prev->next = node;
+            other.head.next = other.head.prev = &other.head;
             size_ += other.size_;
             other.size_ = 0;
+            if (other.index_ != nullptr) {
+                other.index_->clear();
+            }
+            index_linked(first, count);
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list& other, const_iterator it)
+    {
+        BaseNode *node = const_cast<BaseNode*>(it.ptr);
+        BaseNode *next = const_cast<BaseNode*>(pos.ptr);
+        if (next == node || next == node->next) {
+            return; // элемент уже стоит перед pos
+        }
+        if (this != &other) {
+            share_arenas(other);
+            other.index_unlinking(node, node->next);
+        }
+        // исключаем элемент из старого места и вставляем перед pos
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->prev = next->prev;
+        node->next = next;
+        next->prev->next = node;
+        next->prev = node;
+        if (this != &other) {
+            --other.size_;
+            ++size_;
+            index_linked(node, 1);
+        }
+        else {
+            index_invalidate();
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::splice(const_iterator pos, list& other, const_iterator first, const_iterator last)
+    {
+        if (first == last) {
+            return;
         }
+        BaseNode *from = const_cast<BaseNode*>(first.ptr);
+        BaseNode *to = const_cast<BaseNode*>(last.ptr); // первый элемент после диапазона
+        BaseNode *next = const_cast<BaseNode*>(pos.ptr);
+        if (next == to) {
+            return; // диапазон уже стоит перед pos
+        }
+        size_t count = 0;
+        if (this != &other) {
+            count = std::distance(first, last);
+            share_arenas(other);
+            other.index_unlinking(from, to);
+        }
+        BaseNode *tail = to->prev; // последний элемент диапазона
+        // вырезаем диапазон и вставляем его перед pos
+        from->prev->next = to;
+        to->prev = from->prev;
+        from->prev = next->prev;
+        tail->next = next;
+        next->prev->next = from;
+        next->prev = tail;
+        if (this != &other) {
+            other.size_ -= count;
+            size_ += count;
+            index_linked(from, count);
+        }
+        else {
+            index_invalidate();
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::unlink_to_chain(BaseNode* node, BaseNode*& chain) noexcept
+    {
+        // цепочка растет в обратном порядке: тогда уничтожение начинается с элементов,
+        // которые только что были просмотрены и еще лежат в кэше
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+        node->next = chain;
+        chain = node;
     }
     
     // удаление элемента по значению
     template <class T, class Alloc>
-    void task::list<T, Alloc>::remove(const T& value)
+    size_t task::list<T, Alloc>::remove(const T& value)
     {
-        // не удаляем элементы "на ходу", т.к. value может быть ссылкой на элемент списка
-        list<iterator> to_del; // список итераторов на удаляемые элементы
-        iterator it = begin();
-        
-        // проходим по списку и добавляем в список to_del итераторы на элементы для удаления
-        while (it != end()) {
-            if (*it == value) {
-                to_del.push_back(it);
+        return remove_if([&value](const T& element) { return element == value; });
+    }
+    
+    template <class T, class Alloc>
+    template <class UnaryPredicate>
+    size_t task::list<T, Alloc>::remove_if(UnaryPredicate pred)
+    {
+        // удаляемые элементы за один проход переносятся в отдельную цепочку и уничтожаются в конце:
+        // проверяемое значение может быть ссылкой на элемент списка и должно оставаться живым
+        BaseNode *removed = nullptr;
+        BaseNode *node = head.next;
+        try {
+            while (node != &head) {
+                BaseNode *next = node->next;
+                if (pred(value(node))) {
+                    unlink_to_chain(node, removed);
+                }
+                node = next;
             }
-            ++it;
         }
-        
-        // удаляем элементы
-        for (auto it = to_del.begin(); it != to_del.end(); ++it) {
-            erase(*it);
+        catch (...) {
+            // уже исключенные элементы удаляются и при исключении из pred
+            erase_chain(removed);
+            throw;
+        }
+        return erase_chain(removed);
+    }
+    
+    template <class T, class Alloc>
+    size_t list<T, Alloc>::erase_chain(BaseNode* removed) noexcept
+    {
+        size_t count = destroy_chain(removed);
+        size_ -= count;
+        if (count > 0) {
+            index_invalidate();
         }
+        return count;
     }
     
     // обращение порядка элементов
@@ -816,86 +1432,923 @@ public:
     template <class T, class Alloc>
     void task::list<T, Alloc>::reverse()
     {
-        // проходим по списку и делаем предыдущие элементы следующими и наоборот
-        Node *node = first->next;
-        while (node != last) {
-            Node *next = node->next;
+        // проходим по кольцу, включая границу списка, и делаем предыдущие элементы следующими и наоборот
+        BaseNode *node = &head;
+        do {
+            BaseNode *next = node->next;
             node->next = node->prev;
             node->prev = next;
             node = next;
-        }
-        
-        // меняем первый элемент с последним
-        first->prev = first->next;
-        first->next = nullptr;
-        last->next = last->prev;
-        last->prev = nullptr;
-        node = first;
-        first = last;
-        last = node;
+        } while (node != &head);
+        index_invalidate();
     }
     
-    // удаление идущих подряд уникальных элементов
+    // удаление идущих подряд одинаковых элементов
     template <class T, class Alloc>
-    void task::list<T, Alloc>::unique()
+    size_t task::list<T, Alloc>::unique()
     {
-        iterator it = begin();
-        while (it != --end()) {
-            if (*it == *(++it)) {
-                it = erase(it);
-                --it;
+        return unique(std::equal_to<T>());
+    }
+    
+    template <class T, class Alloc>
+    template <class BinaryPredicate>
+    size_t task::list<T, Alloc>::unique(BinaryPredicate pred)
+    {
+        if (empty()) {
+            return 0;
+        }
+        // каждый элемент сравнивается с последним оставленным
+        BaseNode *removed = nullptr;
+        BaseNode *kept = head.next;
+        BaseNode *node = kept->next;
+        try {
+            while (node != &head) {
+                BaseNode *next = node->next;
+                if (pred(value(kept), value(node))) {
+                    unlink_to_chain(node, removed);
+                }
+                else {
+                    kept = node;
+                }
+                node = next;
             }
         }
+        catch (...) {
+            erase_chain(removed);
+            throw;
+        }
+        return erase_chain(removed);
     }
     
     // сортировка (слиянием)
     template <class T, class Alloc>
     void task::list<T, Alloc>::sort()
     {
-        // рекурсивный вызов при размере списка больше 1
+        sort(std::less<T>());
+    }
+    
+    // итеративная сортировка слиянием снизу вверх: только перестановка указателей,
+    // без выделения памяти и без копирования/перемещения элементов
+    template <class T, class Alloc>
+    template <class Compare>
+    void task::list<T, Alloc>::sort(Compare comp)
+    {
+        if (size_ < 2) {
+            return;
+        }
+        
+        // отсоединяем элементы от границ списка: дальше работаем с цепочкой по next
+        head.prev->next = nullptr;
+        BaseNode *chain = head.next;
+        auto less = [&comp](BaseNode* a, BaseNode* b) { return comp(value(a), value(b)); };
+        try {
+            sort_chain(chain, less);
+        }
+        catch (...) {
+            restore_links(chain);
+            throw;
+        }
+        restore_links(chain);
+    }
+    
+    template <class T, class Alloc>
+    void task::list<T, Alloc>::parallel_sort(size_t thread_count)
+    {
+        parallel_sort(std::less<T>(), thread_count);
+    }
+    
+    template <class T, class Alloc>
+    template <class Compare>
+    void task::list<T, Alloc>::parallel_sort(Compare comp, size_t thread_count)
+    {
+        size_t parts = std::min(thread_count, size_ / PARALLEL_SORT_MIN_PART);
+        if (parts < 2) {
+            sort(comp);
+            return;
+        }
         
-        if (size_ > 1) {
+        // разрезаем список на parts цепочек почти равной длины, сохраняя порядок частей
+        std::vector<BaseNode*> chains(parts);
+        head.prev->next = nullptr;
+        BaseNode *node = head.next;
+        for (size_t i = 0; i < parts; ++i) {
+            chains[i] = node;
+            size_t length = size_ / parts + (i < size_ % parts ? 1 : 0);
+            for (size_t j = 1; j < length; ++j) {
+                node = node->next;
+            }
+            BaseNode *next = node->next;
+            node->next = nullptr;
+            node = next;
+        }
+        
+        try {
+            // каждая часть сортируется в своем потоке своей копией компаратора
+            auto sort_part = [&chains, &comp](size_t i) {
+                Compare part_comp = comp;
+                auto less = [&part_comp](BaseNode* a, BaseNode* b) { return part_comp(value(a), value(b)); };
+                sort_chain(chains[i], less);
+            };
+            run_parallel(0, parts, 1, sort_part);
             
-            // разделяем список на два
-            list left, right;
-            Node *l_node = left.first, *r_node = right.first;
-            Node *node = first->next;
-            int count = 0;
-            while (count < size_) {
-                if (count < size_/2) {
-                    l_node->next = node;
-                    node->prev = l_node;
-                    l_node = l_node->next;
-                    left.size_++;
+            // дерево слияний: на каждом уровне соседние пары сливаются параллельно,
+            // левая (более ранняя) цепочка передается первой, поэтому сортировка устойчива
+            for (size_t step = 1; step < parts; step *= 2) {
+                auto merge_pair = [&chains, &comp, step](size_t i) {
+                    if (i + step < chains.size()) {
+                        Compare part_comp = comp;
+                        auto less = [&part_comp](BaseNode* a, BaseNode* b) { return part_comp(value(a), value(b)); };
+                        merge_chains(chains[i], chains[i + step], less);
+                    }
+                };
+                run_parallel(0, parts, 2 * step, merge_pair);
+            }
+        }
+        catch (...) {
+            // цепочки не теряют элементов и при исключении: сцепляем их и возвращаем в список
+            BaseNode **tail = &chains[0];
+            for (size_t i = 0; i < parts; ++i) {
+                for (*tail = chains[i]; *tail != nullptr; tail = &(*tail)->next) {
+                }
+            }
+            restore_links(chains[0]);
+            throw;
+        }
+        
+        restore_links(chains[0]);
+    }
+    
+    template <class T, class Alloc>
+    template <class Task>
+    void list<T, Alloc>::run_parallel(size_t first, size_t last, size_t step, Task& task)
+    {
+        if (first >= last) {
+            return;
+        }
+        size_t count = (last - first + step - 1) / step;
+        std::vector<std::exception_ptr> errors(count);
+        // ничего не бросает: между запуском потоков и join исключения не выходят наружу
+        auto guarded = [&task, &errors, first, step](size_t k) noexcept {
+            try {
+                task(first + k * step);
+            }
+            catch (...) {
+                errors[k] = std::current_exception();
+            }
+        };
+        std::vector<std::thread> workers;
+        size_t launched = 1;
+        try {
+            workers.reserve(count - 1);
+            for (; launched < count; ++launched) {
+                workers.emplace_back(guarded, launched);
+            }
+        }
+        catch (...) {
+            // поток не создан: оставшиеся задачи выполняет вызывающий поток
+        }
+        guarded(0);
+        for (size_t k = launched; k < count; ++k) {
+            guarded(k);
+        }
+        for (std::thread& worker : workers) {
+            worker.join();
+        }
+        for (std::exception_ptr& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+    
+    template <class T, class Alloc>
+    std::vector<const typename list<T, Alloc>::BaseNode*> list<T, Alloc>::split_points(size_t block) const
+    {
+        std::vector<const BaseNode*> points;
+        points.reserve((size_ + block - 1) / block);
+        if (index_type *index = ready_index()) {
+            for (size_t position = 0; position < size_; position += block) {
+                points.push_back(static_cast<const BaseNode*>(index->nth(position)));
+            }
+            return points;
+        }
+        const BaseNode *node = head.next;
+        for (size_t position = 0; position < size_; ++position, node = node->next) {
+            if (position % block == 0) {
+                points.push_back(node);
+            }
+        }
+        return points;
+    }
+    
+    template <class T, class Alloc>
+    template <class UnaryFunction>
+    void list<T, Alloc>::parallel_for_each(UnaryFunction f, size_t thread_count)
+    {
+        size_t parts = std::min(thread_count, size_ / PARALLEL_MIN_PART);
+        if (parts < 2) {
+            for (BaseNode *node = head.next; node != &head; node = node->next) {
+                f(value(node));
+            }
+            return;
+        }
+        
+        size_t block = (size_ + parts - 1) / parts;
+        std::vector<const BaseNode*> points = split_points(block);
+        auto process = [this, &points, &f, block](size_t i) {
+            UnaryFunction part_f = f;
+            BaseNode *node = const_cast<BaseNode*>(points[i]);
+            for (size_t j = 0; j < block && node != &head; ++j, node = node->next) {
+                part_f(value(node));
+            }
+        };
+        // первый отрезок обходит вызывающий поток
+        run_parallel(0, points.size(), 1, process);
+    }
+    
+    template <class T, class Alloc>
+    template <class R, class BinaryOp, class UnaryOp>
+    R list<T, Alloc>::parallel_transform_reduce(R init, BinaryOp reduce, UnaryOp transform, size_t thread_count) const
+    {
+        if (empty()) {
+            return init;
+        }
+        // свертка отрезка слева направо, начиная с node; node сдвигается на начало следующего отрезка
+        auto reduce_block = [this](const BaseNode*& node, BinaryOp& reduce, UnaryOp& transform) {
+            R result = transform(static_cast<const Node*>(node)->data);
+            node = node->next;
+            for (size_t j = 1; j < PARALLEL_REDUCE_BLOCK && node != &head; ++j, node = node->next) {
+                result = reduce(std::move(result), transform(static_cast<const Node*>(node)->data));
+            }
+            return result;
+        };
+        if (size_ <= PARALLEL_REDUCE_BLOCK || thread_count < 2) {
+            // те же отрезки в том же порядке, но без прохода для поиска их начал
+            const BaseNode *node = head.next;
+            for (size_t position = 0; position < size_; position += PARALLEL_REDUCE_BLOCK) {
+                init = reduce(std::move(init), reduce_block(node, reduce, transform));
+            }
+            return init;
+        }
+        
+        // без индекса позиций поиск начал отрезков - один дополнительный проход по списку
+        std::vector<const BaseNode*> points = split_points(PARALLEL_REDUCE_BLOCK);
+        std::vector<std::optional<R>> partial(points.size());
+        size_t workers_count = std::max<size_t>(1, std::min(thread_count, points.size()));
+        // поток w сворачивает отрезки [w * blocks / workers, (w + 1) * blocks / workers)
+        auto process = [&](size_t w) {
+            BinaryOp part_reduce = reduce;
+            UnaryOp part_transform = transform;
+            size_t first = w * points.size() / workers_count;
+            size_t last = (w + 1) * points.size() / workers_count;
+            for (size_t i = first; i < last; ++i) {
+                const BaseNode *node = points[i];
+                partial[i].emplace(reduce_block(node, part_reduce, part_transform));
+            }
+        };
+        run_parallel(0, workers_count, 1, process);
+        
+        for (std::optional<R>& block_result : partial) {
+            init = reduce(std::move(init), std::move(*block_result));
+        }
+        return init;
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::restore_links(BaseNode* chain) noexcept
+    {
+        BaseNode *prev = &head;
+        for (BaseNode *node = chain; node != nullptr; node = node->next) {
+            prev->next = node;
+            node->prev = prev;
+            prev = node;
+        }
+        prev->next = &head;
+        head.prev = prev;
+        index_invalidate();
+    }
+    
+    template <class T, class Alloc>
+    template <class Compare>
+    typename list<T, Alloc>::Run list<T, Alloc>::take_run(BaseNode*& node, Compare& comp)
+    {
+        Run run = {node, node, 1};
+        node = node->next;
+        try {
+            if (node != nullptr && comp(value(node), value(run.tail))) {
+                // строго убывающая серия (равных элементов в ней нет, поэтому разворот устойчив):
+                // каждый следующий элемент ставим в начало
+                run.tail->next = nullptr;
+                while (node != nullptr && comp(value(node), value(run.head))) {
+                    BaseNode *next = node->next;
+                    node->next = run.head;
+                    run.head = node;
+                    node = next;
+                    ++run.size;
+                }
+            }
+            else {
+                // неубывающая серия
+                while (node != nullptr && !comp(value(node), value(run.tail))) {
+                    run.tail = node;
+                    node = node->next;
+                    ++run.size;
+                }
+                run.tail->next = nullptr;
+            }
+        }
+        catch (...) {
+            // возвращаем начатую серию перед еще не просмотренными элементами
+            run.tail->next = node;
+            node = run.head;
+            throw;
+        }
+        return run;
+    }
+    
+    template <class T, class Alloc>
+    template <class Compare>
+    void list<T, Alloc>::merge_runs(Run& a, Run& b, Compare& comp)
+    {
+        Run result = {nullptr, nullptr, a.size + b.size};
+        BaseNode *x = a.head, *y = b.head; // первые еще не перенесенные элементы a и b
+        try {
+            // серии уже упорядочены друг относительно друга: сцепляем за O(1)
+            if (!comp(value(b.head), value(a.tail))) {
+                a.tail->next = b.head;
+                result.head = a.head;
+                result.tail = b.tail;
+            }
+            else if (comp(value(b.tail), value(a.head))) {
+                b.tail->next = a.head;
+                result.head = b.head;
+                result.tail = a.tail;
+            }
+            else {
+                // "галоп" для связного списка: элементы одной серии, идущие подряд в результате,
+                // уже связаны между собой, поэтому указатель переписывается только при смене серии
+                BaseNode **tail = &result.head;
+                while (result.tail == nullptr) {
+                    if (!comp(value(y), value(x))) {
+                        // участок из a: все элементы, не большие y
+                        *tail = x;
+                        BaseNode *prev = x;
+                        for (x = x->next; x != nullptr && !comp(value(y), value(x)); x = x->next) {
+                            prev = x;
+                        }
+                        tail = &prev->next;
+                        if (x == nullptr) {
+                            *tail = y;
+                            result.tail = b.tail;
+                            break;
+                        }
+                    }
+                    // участок из b: все элементы, строго меньшие x
+                    *tail = y;
+                    BaseNode *prev = y;
+                    for (y = y->next; y != nullptr && comp(value(y), value(x)); y = y->next) {
+                        prev = y;
+                    }
+                    tail = &prev->next;
+                    if (y == nullptr) {
+                        *tail = x;
+                        result.tail = a.tail;
+                    }
+                }
+            }
+        }
+        catch (...) {
+            // слитая часть продолжается остатком одной из серий: дописываем к ней остаток другой
+            if (result.head == nullptr) {
+                a.tail->next = b.head;
+                a.tail = b.tail;
+            }
+            else {
+                BaseNode *last = result.head;
+                while (last->next != nullptr) {
+                    last = last->next;
+                }
+                if (last == a.tail) {
+                    last->next = y;
+                    a.tail = b.tail;
                 }
                 else {
-                    r_node->next = node;
-                    node->prev = r_node;
-                    r_node = r_node->next;
-                    right.size_++;
+                    last->next = x;
                 }
-                node = node->next;
-                count++;
+                a.head = result.head;
             }
-            
-            
-            left.last->prev = l_node;
-            l_node->next = left.last;
-            right.last->prev = r_node;
-            r_node->next = right.last;
-            
-            // удаляем левый и правый списки из текущего
-            first->next = last;
-            last->prev = first;
-            size_ = 0;
-            
-            // сортируем оба списка
-            left.sort();
-            right.sort();
-            
-            left.merge(right); // слияние
-            (*this) = left; // левый список становится основным
+            a.size = result.size;
+            b = {nullptr, nullptr, 0};
+            throw;
+        }
+        a = result;
+        b = {nullptr, nullptr, 0};
+    }
+    
+    template <class T, class Alloc>
+    void task::list<T, Alloc>::adaptive_sort()
+    {
+        adaptive_sort(std::less<T>());
+    }
+    
+    template <class T, class Alloc>
+    template <class Compare>
+    void task::list<T, Alloc>::adaptive_sort(Compare comp)
+    {
+        if (size_ < 2) {
+            return;
+        }
+        
+        head.prev->next = nullptr;
+        BaseNode *node = head.next;
+        
+        // стек серий как в timsort: длины убывают быстрее чисел Фибоначчи,
+        // поэтому глубина стека не превышает ~1.44 * log2(n)
+        Run runs[sizeof(size_t) * 16];
+        size_t count = 0;
+        auto merge_at = [&](size_t k) {
+            merge_runs(runs[k], runs[k + 1], comp);
+            for (size_t i = k + 1; i + 1 < count; ++i) {
+                runs[i] = runs[i + 1];
+            }
+            --count;
+        };
+        
+        try {
+            while (node != nullptr) {
+                Run run = take_run(node, comp);
+                runs[count++] = run;
+                // восстанавливаем инварианты: runs[k-1] > runs[k] + runs[k+1] и runs[k] > runs[k+1]
+                while (count > 1) {
+                    size_t k = count - 2;
+                    if ((k > 0 && runs[k - 1].size <= runs[k].size + runs[k + 1].size) ||
+                        (k > 1 && runs[k - 2].size <= runs[k - 1].size + runs[k].size)) {
+                        if (runs[k - 1].size < runs[k + 1].size) {
+                            --k;
+                        }
+                    }
+                    else if (runs[k].size > runs[k + 1].size) {
+                        break;
+                    }
+                    merge_at(k);
+                }
+            }
+            while (count > 1) {
+                merge_at(count - 2);
+            }
+        }
+        catch (...) {
+            // сцепляем все серии (пустые пропускаем) и непросмотренный остаток и возвращаем их в список
+            BaseNode *chain = node;
+            for (size_t i = count; i > 0; --i) {
+                if (runs[i - 1].head != nullptr) {
+                    runs[i - 1].tail->next = chain;
+                    chain = runs[i - 1].head;
+                }
+            }
+            restore_links(chain);
+            throw;
+        }
+        
+        restore_links(runs[0].head);
+    }
+
+    template <class T, class Alloc>
+    void task::list<T, Alloc>::radix_sort()
+    {
+        radix_sort([](const T& element) { return element; });
+    }
+    
+    template <class T, class Alloc>
+    template <class KeyFn>
+    void task::list<T, Alloc>::radix_sort(KeyFn key)
+    {
+        using Key = std::decay_t<decltype(key(std::declval<const T&>()))>;
+        static_assert(std::is_integral<Key>::value && !std::is_same<Key, bool>::value,
+                      "radix_sort requires an integral key");
+        using UKey = std::make_unsigned_t<Key>;
+        constexpr size_t KEY_BITS = sizeof(UKey) * 8;
+        // каждый проход - обход списка в случайном порядке адресов, поэтому выгоднее меньше проходов:
+        // разряд из 11 бит (таблица 2048 корзин - 32 КБ) дает 3 прохода для 32-битного ключа вместо 4
+        constexpr size_t RADIX_BITS = 11;
+        constexpr size_t RADIX_MASK = (size_t(1) << RADIX_BITS) - 1;
+        
+        if (size_ < 2) {
+            return;
+        }
+        
+        // у знаковых ключей инвертируем старший бит, чтобы отрицательные шли раньше
+        auto radix_key = [&key](BaseNode* node) {
+            UKey k = static_cast<UKey>(key(value(node)));
+            if constexpr (std::is_signed<Key>::value) {
+                k ^= UKey(1) << (KEY_BITS - 1);
+            }
+            return k;
+        };
+        
+        // предварительный проход: разряды, одинаковые у всех ключей, не сортируем
+        UKey any_bits = 0, all_bits = ~UKey(0);
+        for (BaseNode *node = head.next; node != &head; node = node->next) {
+            UKey k = radix_key(node);
+            any_bits |= k;
+            all_bits &= k;
+        }
+        UKey varying = any_bits ^ all_bits;
+        
+        head.prev->next = nullptr;
+        BaseNode *chain = head.next;
+        for (size_t shift = 0; shift < KEY_BITS; shift += RADIX_BITS) {
+            if (((varying >> shift) & RADIX_MASK) == 0) {
+                continue;
+            }
+            // раскладываем элементы по корзинам, сохраняя порядок внутри корзины
+            BaseNode *bucket_head[RADIX_MASK + 1] = {};
+            BaseNode *bucket_tail[RADIX_MASK + 1];
+            for (BaseNode *node = chain; node != nullptr; node = node->next) {
+                size_t bucket = (radix_key(node) >> shift) & RADIX_MASK;
+                if (bucket_head[bucket] != nullptr) {
+                    bucket_tail[bucket]->next = node;
+                }
+                else {
+                    bucket_head[bucket] = node;
+                }
+                bucket_tail[bucket] = node;
+            }
+            // сцепляем корзины по порядку
+            BaseNode **link = &chain;
+            for (size_t bucket = 0; bucket <= RADIX_MASK; ++bucket) {
+                if (bucket_head[bucket] != nullptr) {
+                    *link = bucket_head[bucket];
+                    link = &bucket_tail[bucket]->next;
+                }
+            }
+            *link = nullptr;
+        }
+        
+        restore_links(chain);
+    }
+    
+    // уплотнение списка
+    
+    template <class T, class Alloc>
+    typename list<T, Alloc>::Arena* list<T, Alloc>::find_arena(const BaseNode* node) const noexcept
+    {
+        // последний блок, начинающийся не дальше node; std::less - полный порядок указателей из разных блоков
+        std::less<const BaseNode*> less;
+        auto it = std::upper_bound(arenas.begin(), arenas.end(), node,
+                                   [&less](const BaseNode* n, const Arena* arena) { return less(n, arena->nodes); });
+        if (it == arenas.begin()) {
+            return nullptr;
+        }
+        Arena *arena = *--it;
+        return less(node, arena->nodes + arena->capacity) ? arena : nullptr;
+    }
+    
+    template <class T, class Alloc>
+    typename list<T, Alloc>::arena_vector::const_iterator list<T, Alloc>::arena_position(const Arena* arena) const noexcept
+    {
+        std::less<const BaseNode*> less;
+        return std::lower_bound(arenas.begin(), arenas.end(), arena,
+                                [&less](const Arena* a, const Arena* b) { return less(a->nodes, b->nodes); });
+    }
+    
+    template <class T, class Alloc>
+    bool list<T, Alloc>::has_arena(const Arena* arena) const noexcept
+    {
+        auto it = arena_position(arena);
+        return it != arenas.end() && *it == arena;
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::insert_arena(Arena* arena) noexcept
+    {
+        arenas.insert(arena_position(arena), arena); // память зарезервирована заранее, перенос указателей не бросает
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::free_node(Node* node) noexcept
+    {
+        node_traits::destroy(allocator, node);
+        ++churn_;
+        if (!arenas.empty()) {
+            if (Arena *arena = find_arena(node)) {
+                // список держит ссылку на блок, поэтому refs здесь не обнуляется
+                --arena->refs;
+                return;
+            }
+        }
+        node_traits::deallocate(allocator, node, 1);
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::release_arenas() noexcept
+    {
+        arena_allocator_type arena_allocator(allocator);
+        for (Arena *arena : arenas) {
+            if (--arena->refs == 0) {
+                node_traits::deallocate(allocator, arena->nodes, arena->capacity);
+                arena_traits::deallocate(arena_allocator, arena, 1);
+            }
+        }
+        arenas.clear();
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::replace_arenas(arena_vector&& source) noexcept
+    {
+        // перемещающий конструктор вектора всегда забирает аллокатор source и не бросает
+        arenas.~arena_vector();
+        ::new (static_cast<void*>(&arenas)) arena_vector(std::move(source));
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::reserve_arenas(const list& other)
+    {
+        // память под ссылки выделяется только для новых блоков, чтобы дальнейшие push_back не бросали
+        size_t missing = 0;
+        for (Arena *arena : other.arenas) {
+            if (!has_arena(arena)) {
+                ++missing;
+            }
+        }
+        if (missing > 0) {
+            arenas.reserve(arenas.size() + missing);
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::share_arenas(const list& other)
+    {
+        reserve_arenas(other);
+        for (Arena *arena : other.arenas) {
+            if (!has_arena(arena)) {
+                insert_arena(arena);
+                ++arena->refs;
+            }
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::adopt_arenas(list& other)
+    {
+        reserve_arenas(other);
+        for (Arena *arena : other.arenas) {
+            if (!has_arena(arena)) {
+                insert_arena(arena);
+            }
+            else {
+                --arena->refs; // у этого списка уже есть ссылка на блок
+            }
+        }
+        other.arenas.clear();
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::compact()
+    {
+        churn_ = 0;
+        if (empty()) {
+            release_arenas();
+            return;
+        }
+        
+        arena_allocator_type arena_allocator(allocator);
+        Arena *arena = arena_traits::allocate(arena_allocator, 1);
+        Node *nodes = nullptr;
+        size_t built = 0;
+        try {
+            arenas.reserve(arenas.size() + 1);
+            nodes = node_traits::allocate(allocator, size_);
+            for (BaseNode *node = head.next; node != &head; node = node->next, ++built) {
+                node_traits::construct(allocator, nodes + built, nullptr, nullptr, std::move_if_noexcept(value(node)));
+            }
+        } catch (...) {
+            for (size_t i = 0; i < built; ++i) {
+                node_traits::destroy(allocator, nodes + i);
+            }
+            if (nodes != nullptr) {
+                node_traits::deallocate(allocator, nodes, size_);
+            }
+            arena_traits::deallocate(arena_allocator, arena, 1);
+            throw;
+        }
+        
+        // новые элементы связываются в порядке расположения в памяти, старые уничтожаются
+        BaseNode *old = head.next;
+        head.prev->next = nullptr;
+        BaseNode *prev = &head;
+        for (size_t i = 0; i < size_; ++i) {
+            nodes[i].prev = prev;
+            prev->next = nodes + i;
+            prev = nodes + i;
+        }
+        prev->next = &head;
+        head.prev = prev;
+        destroy_chain(old);
+        release_arenas();
+        index_invalidate();
+        
+        arena->nodes = nodes;
+        arena->capacity = size_;
+        arena->refs = size_ + 1;
+        insert_arena(arena);
+        churn_ = 0;
+    }
+    
+    template <class T, class Alloc>
+    double list<T, Alloc>::address_jump_score() const
+    {
+        if (size_ < 2) {
+            return 0;
+        }
+        // переход считается близким, если следующий элемент начинается не дальше кэш-линии
+        // (или размера элемента, если он больше) после текущего
+        const std::uintptr_t near = std::max<std::uintptr_t>(64, sizeof(Node));
+        size_t jumps = 0;
+        for (const BaseNode *node = head.next; node->next != &head; node = node->next) {
+            std::uintptr_t from = reinterpret_cast<std::uintptr_t>(node);
+            std::uintptr_t to = reinterpret_cast<std::uintptr_t>(node->next);
+            if (to <= from || to - from > near) {
+                ++jumps;
+            }
+        }
+        return static_cast<double>(jumps) / (size_ - 1);
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::auto_compact(double threshold)
+    {
+        compact_threshold_ = threshold;
+        churn_ = 0;
+    }
+    
+    template <class T, class Alloc>
+    bool list<T, Alloc>::compact_if_scattered() noexcept
+    {
+        // проверка стоит O(n), но выполняется не чаще, чем через size() изменений;
+        // неперемещаемые значения перенести нельзя, для них уплотнение не выполняется
+        if constexpr (std::is_move_constructible<T>::value) {
+            if (compact_threshold_ > 1 || churn_ < std::max(size_, AUTO_COMPACT_MIN_CHURN)) {
+                return false;
+            }
+            churn_ = 0;
+            if (address_jump_score() > compact_threshold_) {
+                try {
+                    compact();
+                    return true;
+                } catch (...) {
+                    // уплотнение - только оптимизация: при ошибке список остается прежним
+                }
+            }
+        }
+        return false;
+    }
+
+    // индекс позиций
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::index_linked(BaseNode* first, size_t count) noexcept
+    {
+        if (index_ == nullptr || !index_->valid()) {
+            return;
+        }
+        size_t position = (first->prev == &head) ? 0 : index_->rank(first->prev) + 1;
+        try {
+            index_->insert(position, first, count, next_of);
+        } catch (...) {
+            // индекс сам помечает себя устаревшим и будет перестроен при следующем запросе
+        }
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::index_unlinking(BaseNode* first, BaseNode* last) noexcept
+    {
+        if (index_ == nullptr || !index_->valid()) {
+            return;
+        }
+        size_t from = index_->rank(first);
+        size_t to = (last == &head) ? index_->size() : index_->rank(last);
+        index_->erase(from, to - from);
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::index_invalidate() noexcept
+    {
+        if (index_ != nullptr) {
+            index_->invalidate();
+        }
+    }
+    
+    template <class T, class Alloc>
+    typename list<T, Alloc>::index_type* list<T, Alloc>::ready_index() const
+    {
+        if (index_ != nullptr && !index_->valid()) {
+            index_->assign(head.next, size_, next_of);
+        }
+        return index_;
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::enable_index()
+    {
+        if (index_ != nullptr) {
+            return;
+        }
+        index_allocator_type index_allocator(allocator);
+        index_type *index = std::allocator_traits<index_allocator_type>::allocate(index_allocator, 1);
+        std::allocator_traits<index_allocator_type>::construct(index_allocator, index, Alloc(allocator));
+        try {
+            index->assign(head.next, size_, next_of);
+        } catch (...) {
+            std::allocator_traits<index_allocator_type>::destroy(index_allocator, index);
+            std::allocator_traits<index_allocator_type>::deallocate(index_allocator, index, 1);
+            throw;
+        }
+        index_ = index;
+    }
+    
+    template <class T, class Alloc>
+    void list<T, Alloc>::disable_index() noexcept
+    {
+        if (index_ != nullptr) {
+            index_allocator_type index_allocator(allocator);
+            std::allocator_traits<index_allocator_type>::destroy(index_allocator, index_);
+            std::allocator_traits<index_allocator_type>::deallocate(index_allocator, index_, 1);
+            index_ = nullptr;
+        }
+    }
+    
+    template <class T, class Alloc>
+    bool list<T, Alloc>::has_index() const
+    {
+        return index_ != nullptr;
+    }
+    
+    template <class T, class Alloc>
+    T& list<T, Alloc>::at(size_t n)
+    {
+        if (n >= size_) {
+            throw std::out_of_range("task::list::at");
+        }
+        return *nth(n);
+    }
+    
+    template <class T, class Alloc>
+    const T& list<T, Alloc>::at(size_t n) const
+    {
+        if (n >= size_) {
+            throw std::out_of_range("task::list::at");
+        }
+        return *nth(n);
+    }
+    
+    template <class T, class Alloc>
+    typename list<T, Alloc>::iterator list<T, Alloc>::nth(size_t n)
+    {
+        const_iterator found = static_cast<const list&>(*this).nth(n);
+        iterator it;
+        it.ptr = const_cast<BaseNode*>(found.ptr);
+        return it;
+    }
+    
+    template <class T, class Alloc>
+    typename list<T, Alloc>::const_iterator list<T, Alloc>::nth(size_t n) const
+    {
+        const_iterator it;
+        if (n < size_ && ready_index() != nullptr) {
+            it.ptr = static_cast<const BaseNode*>(index_->nth(n));
+            return it;
+        }
+        // без индекса идем от ближайшего конца
+        if (n <= size_ / 2) {
+            it = cbegin();
+            for (; n > 0; --n) {
+                ++it;
+            }
+        }
+        else {
+            it = cend();
+            for (n = size_ - n; n > 0; --n) {
+                --it;
+            }
+        }
+        return it;
+    }
+    
+    template <class T, class Alloc>
+    size_t list<T, Alloc>::index_of(const_iterator it) const
+    {
+        if (it.ptr == &head) {
+            return size_;
+        }
+        if (ready_index() != nullptr) {
+            return index_->rank(it.ptr);
+        }
+        size_t n = 0;
+        for (const_iterator i = cbegin(); i != it; ++i) {
+            ++n;
         }
+        return n;
     }
 
 }  // namespace task
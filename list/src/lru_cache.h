@@ -0,0 +1,228 @@
+#pragma once
+#include <algorithm> // для std::fill
+#include <functional> // для std::hash, std::equal_to, std::function
+#include <memory> // для allocator_traits
+#include <utility>
+#include <vector>
+#include "list.h"
+
+namespace task {
+
+// LRU-кэш на task::list: элементы стоят в порядке использования (в начале - самый свежий),
+// обращение переносит элемент в начало через splice за O(1).
+// Все capacity элементов создаются в конструкторе (одним непрерывным блоком, см. list::compact),
+// индекс - открытая адресация с линейным пробированием в таблице фиксированного размера,
+// поэтому get и put в установившемся режиме не обращаются к аллокатору (кроме присваиваний
+// самих Key и Value). Key и Value должны быть конструируемыми по умолчанию и присваиваемыми.
+// on_evict вызывается для элемента, вытесняемого из полного кэша при put; erase и clear его не вызывают
+template <class Key, class Value, class Hash = std::hash<Key>, class KeyEqual = std::equal_to<Key>,
+          class Alloc = std::allocator<std::pair<Key, Value>>>
+class lru_cache {
+public:
+    using value_type = std::pair<Key, Value>;
+    using eviction_callback = std::function<void(const Key&, Value&)>;
+
+private:
+    using list_type = list<value_type, Alloc>;
+    using slot_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<typename list_type::iterator>;
+
+    list_type items; // элементы кэша, в начале - последний использованный
+    list_type spare; // заранее созданные свободные элементы
+    // хеш-таблица: пустая ячейка - итератор по умолчанию; размер - степень двойки не меньше 2 * capacity
+    std::vector<typename list_type::iterator, slot_allocator_type> slots;
+    size_t capacity_;
+    Hash hash;
+    KeyEqual equal;
+    eviction_callback on_evict;
+
+    size_t home(const Key& key) const { return hash(key) & (slots.size() - 1); }
+    // ячейка с ключом key или пустая ячейка, в которой он должен оказаться
+    size_t find_slot(const Key& key) const;
+    // освобождение ячейки с обратным сдвигом следующих за ней ключей, без надгробий
+    void erase_slot(size_t slot);
+
+public:
+    explicit lru_cache(size_t capacity, eviction_callback on_evict = eviction_callback(),
+                       const Hash& hash = Hash(), const KeyEqual& equal = KeyEqual(), const Alloc& alloc = Alloc());
+
+    lru_cache(const lru_cache&) = delete;
+    lru_cache& operator=(const lru_cache&) = delete;
+
+    size_t size() const;
+    size_t capacity() const;
+    bool empty() const;
+
+    // значение по ключу с переносом элемента в начало; nullptr, если ключа нет
+    Value* get(const Key& key);
+    // проверка наличия ключа без изменения порядка
+    bool contains(const Key& key) const;
+    // вставка или замена значения с переносом элемента в начало; при заполненном кэше
+    // вытесняется последний использованный элемент. Возвращает true, если ключ был новым
+    template <class K, class V>
+    bool put(K&& key, V&& value);
+    // удаление ключа; элемент возвращается в запас
+    bool erase(const Key& key);
+    void clear();
+
+    // элементы от последнего использованного к самому давнему
+    typename list_type::const_iterator cbegin() const;
+    typename list_type::const_iterator cend() const;
+};
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    size_t lru_cache<Key, Value, Hash, KeyEqual, Alloc>::find_slot(const Key& key) const
+    {
+        size_t mask = slots.size() - 1;
+        size_t slot = home(key);
+        while (slots[slot] != typename list_type::iterator() && !equal(slots[slot]->first, key)) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    void lru_cache<Key, Value, Hash, KeyEqual, Alloc>::erase_slot(size_t slot)
+    {
+        size_t mask = slots.size() - 1;
+        size_t next = slot;
+        while (true) {
+            next = (next + 1) & mask;
+            if (slots[next] == typename list_type::iterator()) {
+                break;
+            }
+            // ключ из next можно сдвинуть в slot, если slot лежит на пути от его домашней ячейки до next
+            size_t ideal = home(slots[next]->first);
+            if (((next - ideal) & mask) >= ((next - slot) & mask)) {
+                slots[slot] = slots[next];
+                slot = next;
+            }
+        }
+        slots[slot] = typename list_type::iterator();
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    lru_cache<Key, Value, Hash, KeyEqual, Alloc>::lru_cache(size_t capacity, eviction_callback on_evict,
+                                                            const Hash& hash, const KeyEqual& equal, const Alloc& alloc)
+        : items(alloc), spare(capacity, alloc), slots(slot_allocator_type(alloc)), capacity_(capacity),
+          hash(hash), equal(equal), on_evict(std::move(on_evict))
+    {
+        // запас элементов лежит в памяти подряд: обход и вытеснение затрагивают соседние строки кэша
+        spare.compact();
+        size_t table_size = 2;
+        while (table_size < 2 * capacity) {
+            table_size *= 2;
+        }
+        slots.resize(table_size);
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    size_t lru_cache<Key, Value, Hash, KeyEqual, Alloc>::size() const
+    {
+        return items.size();
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    size_t lru_cache<Key, Value, Hash, KeyEqual, Alloc>::capacity() const
+    {
+        return capacity_;
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    bool lru_cache<Key, Value, Hash, KeyEqual, Alloc>::empty() const
+    {
+        return items.empty();
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    Value* lru_cache<Key, Value, Hash, KeyEqual, Alloc>::get(const Key& key)
+    {
+        typename list_type::iterator it = slots[find_slot(key)];
+        if (it == typename list_type::iterator()) {
+            return nullptr;
+        }
+        items.splice(items.cbegin(), items, it);
+        return &it->second;
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    bool lru_cache<Key, Value, Hash, KeyEqual, Alloc>::contains(const Key& key) const
+    {
+        return slots[find_slot(key)] != typename list_type::iterator();
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    template <class K, class V>
+    bool lru_cache<Key, Value, Hash, KeyEqual, Alloc>::put(K&& key, V&& value)
+    {
+        if (capacity_ == 0) {
+            return false;
+        }
+        size_t slot = find_slot(key);
+        typename list_type::iterator it = slots[slot];
+        if (it != typename list_type::iterator()) {
+            it->second = std::forward<V>(value);
+            items.splice(items.cbegin(), items, it);
+            return false;
+        }
+
+        if (spare.empty()) {
+            // вытесняем самый давний элемент и используем его узел для нового ключа
+            it = std::prev(items.end());
+            if (on_evict) {
+                on_evict(it->first, it->second);
+            }
+            erase_slot(find_slot(it->first));
+            items.splice(items.cbegin(), items, it);
+            slot = find_slot(key); // после сдвига ячеек место ключа могло измениться
+        }
+        else {
+            it = spare.begin();
+            items.splice(items.cbegin(), spare, it);
+        }
+        try {
+            it->first = std::forward<K>(key);
+            it->second = std::forward<V>(value);
+        } catch (...) {
+            // элемент с частично присвоенным значением в кэш не попадает
+            spare.splice(spare.cbegin(), items, it);
+            throw;
+        }
+        slots[slot] = it;
+        return true;
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    bool lru_cache<Key, Value, Hash, KeyEqual, Alloc>::erase(const Key& key)
+    {
+        size_t slot = find_slot(key);
+        typename list_type::iterator it = slots[slot];
+        if (it == typename list_type::iterator()) {
+            return false;
+        }
+        erase_slot(slot);
+        spare.splice(spare.cbegin(), items, it);
+        return true;
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    void lru_cache<Key, Value, Hash, KeyEqual, Alloc>::clear()
+    {
+        std::fill(slots.begin(), slots.end(), typename list_type::iterator());
+        spare.splice(spare.cbegin(), items);
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    typename lru_cache<Key, Value, Hash, KeyEqual, Alloc>::list_type::const_iterator
+    lru_cache<Key, Value, Hash, KeyEqual, Alloc>::cbegin() const
+    {
+        return items.cbegin();
+    }
+
+    template <class Key, class Value, class Hash, class KeyEqual, class Alloc>
+    typename lru_cache<Key, Value, Hash, KeyEqual, Alloc>::list_type::const_iterator
+    lru_cache<Key, Value, Hash, KeyEqual, Alloc>::cend() const
+    {
+        return items.cend();
+    }
+
+}  // namespace task
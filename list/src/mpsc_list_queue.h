@@ -0,0 +1,190 @@
+#pragma once
+#include <atomic>
+#include <memory> // для allocator_traits
+#include <utility>
+#include "list.h"
+
+namespace task {
+
+// очередь многих производителей и одного потребителя на элементах task::list.
+// push_back/emplace_back можно вызывать из любых потоков одновременно: элемент добавляется
+// в стек ожидающих одной успешной операцией compare_exchange (lock-free, без мьютекса).
+// pop_front, drain, empty и size вызывает только один поток-потребитель: он забирает весь стек
+// одной операцией exchange и разворачивает его в порядок поступления, ни на чем не ожидая (wait-free).
+// Элементы имеют тот же вид, что и элементы list<T, Alloc>, поэтому drain включает их в список
+// целой цепочкой без копирования значений; аллокатор списка должен быть равен аллокатору очереди.
+// Порядок элементов одного производителя сохраняется
+template <class T, class Alloc = std::allocator<T>>
+class mpsc_list_queue {
+public:
+    using list_type = list<T, Alloc>;
+
+private:
+    using BaseNode = typename list_type::BaseNode;
+    using Node = typename list_type::Node;
+    using Chain = typename list_type::Chain;
+    using allocator_type = typename list_type::allocator_type;
+    using node_traits = std::allocator_traits<allocator_type>;
+
+    allocator_type allocator;
+    // стек добавленных, но еще не забранных потребителем элементов, связанный через next;
+    // вершина - последний добавленный
+    std::atomic<BaseNode*> pending;
+    // элементы, уже забранные потребителем, в порядке поступления (связаны через next и prev)
+    Chain ready;
+
+    template <class... Args>
+    void push_node(Args&&... args);
+    // перенос всего стека pending в конец ready
+    void collect() noexcept;
+
+public:
+    explicit mpsc_list_queue(const Alloc& alloc = Alloc());
+    ~mpsc_list_queue();
+
+    mpsc_list_queue(const mpsc_list_queue&) = delete;
+    mpsc_list_queue& operator=(const mpsc_list_queue&) = delete;
+
+    // производители
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <class... Args>
+    void emplace_back(Args&&... args);
+
+    // потребитель: перемещение первого элемента в value; false, если очередь пуста
+    bool pop_front(T& value);
+    // потребитель: перенос всех элементов в конец to за O(количество элементов в стеке) на разворот
+    // и O(1) на включение в список; возвращает количество перенесенных элементов
+    size_t drain(list_type& to) noexcept;
+    // потребитель: пустота и размер на момент вызова (производители могут добавить элементы сразу после)
+    bool empty() noexcept;
+    size_t size() noexcept;
+};
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void mpsc_list_queue<T, Alloc>::push_node(Args&&... args)
+    {
+        Node *node = node_traits::allocate(allocator, 1);
+        try {
+            node_traits::construct(allocator, node, nullptr, nullptr, std::forward<Args>(args)...);
+        } catch (...) {
+            node_traits::deallocate(allocator, node, 1);
+            throw;
+        }
+        // release: значение и next видны потребителю, забравшему стек через acquire
+        BaseNode *top = pending.load(std::memory_order_relaxed);
+        do {
+            node->next = top;
+        } while (!pending.compare_exchange_weak(top, node, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    template <class T, class Alloc>
+    void mpsc_list_queue<T, Alloc>::collect() noexcept
+    {
+        BaseNode *node = pending.exchange(nullptr, std::memory_order_acquire);
+        if (node == nullptr) {
+            return;
+        }
+        // стек идет от последнего добавленного к первому: разворачиваем, заодно проставляя prev
+        Chain taken;
+        taken.last = node;
+        while (node != nullptr) {
+            BaseNode *next = node->next;
+            node->next = taken.first;
+            if (taken.first != nullptr) {
+                taken.first->prev = node;
+            }
+            taken.first = node;
+            ++taken.size;
+            node = next;
+        }
+        if (ready.first == nullptr) {
+            ready = taken;
+        }
+        else {
+            ready.last->next = taken.first;
+            taken.first->prev = ready.last;
+            ready.last = taken.last;
+            ready.size += taken.size;
+        }
+    }
+
+    template <class T, class Alloc>
+    mpsc_list_queue<T, Alloc>::mpsc_list_queue(const Alloc& alloc)
+        : allocator(alloc), pending(nullptr), ready()
+    {
+    }
+
+    template <class T, class Alloc>
+    mpsc_list_queue<T, Alloc>::~mpsc_list_queue()
+    {
+        // оставшиеся элементы уничтожает временный список
+        list_type rest(allocator);
+        drain(rest);
+    }
+
+    template <class T, class Alloc>
+    void mpsc_list_queue<T, Alloc>::push_back(const T& value)
+    {
+        push_node(value);
+    }
+
+    template <class T, class Alloc>
+    void mpsc_list_queue<T, Alloc>::push_back(T&& value)
+    {
+        push_node(std::move(value));
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void mpsc_list_queue<T, Alloc>::emplace_back(Args&&... args)
+    {
+        push_node(std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc>
+    bool mpsc_list_queue<T, Alloc>::pop_front(T& value)
+    {
+        if (ready.first == nullptr) {
+            collect();
+            if (ready.first == nullptr) {
+                return false;
+            }
+        }
+        Node *node = static_cast<Node*>(ready.first);
+        value = std::move(node->data); // при исключении элемент остается в очереди
+        ready.first = node->next;
+        if (ready.first == nullptr) {
+            ready.last = nullptr;
+        }
+        --ready.size;
+        node_traits::destroy(allocator, node);
+        node_traits::deallocate(allocator, node, 1);
+        return true;
+    }
+
+    template <class T, class Alloc>
+    size_t mpsc_list_queue<T, Alloc>::drain(list_type& to) noexcept
+    {
+        collect();
+        size_t count = ready.size;
+        to.link_chain(&to.head, ready);
+        ready = Chain();
+        return count;
+    }
+
+    template <class T, class Alloc>
+    bool mpsc_list_queue<T, Alloc>::empty() noexcept
+    {
+        return ready.first == nullptr && pending.load(std::memory_order_acquire) == nullptr;
+    }
+
+    template <class T, class Alloc>
+    size_t mpsc_list_queue<T, Alloc>::size() noexcept
+    {
+        collect();
+        return ready.size;
+    }
+
+}  // namespace task
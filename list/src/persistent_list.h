@@ -0,0 +1,250 @@
+#pragma once
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+#include "../../smart_pointers/src/smart_pointers.h"
+
+namespace task {
+
+// неизменяемый односвязный список со структурным разделением: каждая версия - указатель на первый
+// элемент, элементы связаны через task::SharedPtr и освобождаются, когда на них не остается ссылок.
+// Копия (snapshot) - O(1), push_front и pop_front возвращают новую версию за O(1), не меняя старую;
+// версии, полученные друг из друга, разделяют общий хвост.
+// Счетчики ссылок SharedPtr не атомарны: версии одного списка нельзя использовать из разных потоков
+template <class T>
+class persistent_list {
+private:
+    struct Node {
+        T data;
+        SharedPtr<Node> next;
+        template <class... Args>
+        Node(const SharedPtr<Node>& next, Args&&... args) : data(std::forward<Args>(args)...), next(next) {};
+    };
+
+    SharedPtr<Node> head;
+    size_t size_;
+
+    persistent_list(SharedPtr<Node> head, size_t size) : head(std::move(head)), size_(size) {};
+    // освобождение цепочки без рекурсии: элементы, на которые больше никто не ссылается,
+    // отцепляются по одному, обход останавливается на первом разделяемом элементе
+    static void release(SharedPtr<Node>& node) noexcept;
+
+public:
+    class const_iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::forward_iterator_tag;
+
+        const_iterator() : ptr(nullptr) {};
+
+        const_iterator& operator++() { ptr = ptr->next.get(); return *this; }
+        const_iterator operator++(int) { const_iterator old = *this; ++*this; return old; }
+        reference operator*() const { return ptr->data; }
+        pointer operator->() const { return &ptr->data; }
+
+        bool operator==(const_iterator other) const { return ptr == other.ptr; }
+        bool operator!=(const_iterator other) const { return ptr != other.ptr; }
+
+        friend class persistent_list;
+    private:
+        const Node *ptr;
+    };
+    using iterator = const_iterator;
+
+    persistent_list() : head(), size_(0) {};
+    // элементы [first, last) в том же порядке, O(last - first)
+    template <class InputIt, class = std::enable_if_t<std::is_convertible<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>>
+    persistent_list(InputIt first, InputIt last);
+
+    // копирование и присваивание - O(1): версии разделяют все элементы
+    persistent_list(const persistent_list& other) = default;
+    persistent_list(persistent_list&& other) noexcept;
+    persistent_list& operator=(const persistent_list& other);
+    persistent_list& operator=(persistent_list&& other) noexcept;
+    ~persistent_list();
+
+    // неизменяемый снимок текущей версии, O(1)
+    persistent_list snapshot() const;
+
+    // новая версия с value в начале, хвост - эта версия
+    persistent_list push_front(const T& value) const;
+    persistent_list push_front(T&& value) const;
+    template <class... Args>
+    persistent_list emplace_front(Args&&... args) const;
+    // новая версия без первого элемента; список не должен быть пуст
+    persistent_list pop_front() const;
+
+    const T& front() const;
+    bool empty() const;
+    size_t size() const;
+
+    const_iterator begin() const;
+    const_iterator end() const;
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    // true, если версии начинаются с одного и того же элемента (и потому совпадают целиком)
+    bool same_as(const persistent_list& other) const;
+};
+
+    template <class T>
+    void persistent_list<T>::release(SharedPtr<Node>& node) noexcept
+    {
+        while (node.get() != nullptr && node.use_count() == 1) {
+            // после переноса next удаление элемента не затрагивает остальную цепочку
+            SharedPtr<Node> next(std::move(node->next));
+            node = std::move(next);
+        }
+        node.reset();
+    }
+
+    template <class T>
+    template <class InputIt, class>
+    persistent_list<T>::persistent_list(InputIt first, InputIt last) : head(), size_(0)
+    {
+        // элементы добавляются в конец: последний элемент пока единственный владелец своего next
+        Node *last_node = nullptr;
+        try {
+            for (; first != last; ++first, ++size_) {
+                SharedPtr<Node> node(new Node(SharedPtr<Node>(), *first));
+                if (last_node == nullptr) {
+                    head = std::move(node);
+                    last_node = head.get();
+                }
+                else {
+                    last_node->next = std::move(node);
+                    last_node = last_node->next.get();
+                }
+            }
+        } catch (...) {
+            release(head);
+            throw;
+        }
+    }
+
+    template <class T>
+    persistent_list<T>::persistent_list(persistent_list&& other) noexcept
+        : head(std::move(other.head)), size_(other.size_)
+    {
+        other.size_ = 0;
+    }
+
+    template <class T>
+    persistent_list<T>& persistent_list<T>::operator=(const persistent_list& other)
+    {
+        if (this != &other) {
+            // сначала ссылка на новую версию, затем освобождение старой: other может быть ее хвостом
+            SharedPtr<Node> old(std::move(head));
+            head = other.head;
+            size_ = other.size_;
+            release(old);
+        }
+        return *this;
+    }
+
+    template <class T>
+    persistent_list<T>& persistent_list<T>::operator=(persistent_list&& other) noexcept
+    {
+        if (this != &other) {
+            SharedPtr<Node> old(std::move(head));
+            head = std::move(other.head);
+            size_ = other.size_;
+            other.size_ = 0;
+            release(old);
+        }
+        return *this;
+    }
+
+    template <class T>
+    persistent_list<T>::~persistent_list()
+    {
+        release(head);
+    }
+
+    template <class T>
+    persistent_list<T> persistent_list<T>::snapshot() const
+    {
+        return *this;
+    }
+
+    template <class T>
+    persistent_list<T> persistent_list<T>::push_front(const T& value) const
+    {
+        return emplace_front(value);
+    }
+
+    template <class T>
+    persistent_list<T> persistent_list<T>::push_front(T&& value) const
+    {
+        return emplace_front(std::move(value));
+    }
+
+    template <class T>
+    template <class... Args>
+    persistent_list<T> persistent_list<T>::emplace_front(Args&&... args) const
+    {
+        return persistent_list(SharedPtr<Node>(new Node(head, std::forward<Args>(args)...)), size_ + 1);
+    }
+
+    template <class T>
+    persistent_list<T> persistent_list<T>::pop_front() const
+    {
+        return persistent_list(head->next, size_ - 1);
+    }
+
+    template <class T>
+    const T& persistent_list<T>::front() const
+    {
+        return head->data;
+    }
+
+    template <class T>
+    bool persistent_list<T>::empty() const
+    {
+        return size_ == 0;
+    }
+
+    template <class T>
+    size_t persistent_list<T>::size() const
+    {
+        return size_;
+    }
+
+    template <class T>
+    typename persistent_list<T>::const_iterator persistent_list<T>::begin() const
+    {
+        return cbegin();
+    }
+
+    template <class T>
+    typename persistent_list<T>::const_iterator persistent_list<T>::end() const
+    {
+        return cend();
+    }
+
+    template <class T>
+    typename persistent_list<T>::const_iterator persistent_list<T>::cbegin() const
+    {
+        const_iterator it;
+        it.ptr = head.get();
+        return it;
+    }
+
+    template <class T>
+    typename persistent_list<T>::const_iterator persistent_list<T>::cend() const
+    {
+        return const_iterator();
+    }
+
+    template <class T>
+    bool persistent_list<T>::same_as(const persistent_list& other) const
+    {
+        return head.get() == other.head.get();
+    }
+
+}  // namespace task
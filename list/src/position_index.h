@@ -0,0 +1,332 @@
+#pragma once
+#include <cstdint>
+#include <functional> // для std::hash, std::equal_to
+#include <memory> // для allocator_traits
+#include <random>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace task {
+
+// индекс позиций для последовательности узлов списка: декартово дерево по неявному ключу
+// (позиции) с размерами поддеревьев и ссылками на родителя, плюс хеш-таблица адрес узла -> вершина.
+// Узлы списка индекс не меняет, он только хранит их адреса в порядке следования.
+// rank и nth - O(log n), вставка и удаление отрезка из count узлов - O(count + log n) (ожидаемо)
+template <class Alloc = std::allocator<char>>
+class position_index {
+private:
+    struct Entry {
+        Entry *left;
+        Entry *right;
+        Entry *parent;
+        const void *key; // адрес узла списка
+        size_t size; // количество вершин в поддереве
+        std::uint32_t priority; // дерево - куча по приоритетам, поэтому его глубина ожидаемо O(log n)
+    };
+    using entry_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Entry>;
+    using entry_traits = std::allocator_traits<entry_allocator_type>;
+    using map_allocator_type =
+        typename std::allocator_traits<Alloc>::template rebind_alloc<std::pair<const void* const, Entry*>>;
+
+    entry_allocator_type allocator;
+    std::unordered_map<const void*, Entry*, std::hash<const void*>, std::equal_to<const void*>, map_allocator_type> entries;
+    Entry *root;
+    std::minstd_rand random;
+    bool valid_; // false - узлы списка переставлены без обновления индекса, нужно перестроение
+
+    static size_t size_of(const Entry* e) { return e != nullptr ? e->size : 0; }
+    // пересчет размера и ссылок детей на родителя после изменения детей
+    static void update(Entry* e);
+    // разделение t на первые k вершин (l) и остальные (r)
+    static void split(Entry* t, size_t k, Entry*& l, Entry*& r);
+    static Entry* merge(Entry* a, Entry* b);
+    // дерево из count узлов, начиная с first, в порядке next(узел)
+    template <class NextFn>
+    Entry* build(const void* first, size_t count, NextFn next);
+    // освобождение поддерева вместе с его записями в хеш-таблице
+    void destroy(Entry* t) noexcept;
+    // уничтожение вершины и освобождение ее памяти, без изменения хеш-таблицы
+    void free_entry(Entry* e) noexcept;
+
+public:
+    explicit position_index(const Alloc& alloc = Alloc());
+    ~position_index();
+
+    position_index(const position_index&) = delete;
+    position_index& operator=(const position_index&) = delete;
+
+    size_t size() const { return size_of(root); }
+    bool valid() const { return valid_; }
+    // пометка о перестановке узлов: индекс будет перестроен через assign
+    void invalidate() noexcept;
+    // пустой корректный индекс
+    void clear() noexcept;
+    // перестроение по всей последовательности за O(count)
+    template <class NextFn>
+    void assign(const void* first, size_t count, NextFn next);
+
+    // вставка count узлов, начиная с first, так, чтобы first оказался на позиции position
+    template <class NextFn>
+    void insert(size_t position, const void* first, size_t count, NextFn next);
+    // удаление count узлов, начиная с позиции position
+    void erase(size_t position, size_t count) noexcept;
+
+    // позиция узла key, который обязан быть в индексе
+    size_t rank(const void* key) const;
+    // узел на позиции position < size()
+    const void* nth(size_t position) const;
+};
+
+    template <class Alloc>
+    void position_index<Alloc>::update(Entry* e)
+    {
+        e->size = 1 + size_of(e->left) + size_of(e->right);
+        if (e->left != nullptr) {
+            e->left->parent = e;
+        }
+        if (e->right != nullptr) {
+            e->right->parent = e;
+        }
+    }
+
+    template <class Alloc>
+    void position_index<Alloc>::split(Entry* t, size_t k, Entry*& l, Entry*& r)
+    {
+        if (t == nullptr) {
+            l = r = nullptr;
+            return;
+        }
+        if (size_of(t->left) < k) {
+            split(t->right, k - size_of(t->left) - 1, t->right, r);
+            l = t;
+        }
+        else {
+            split(t->left, k, l, t->left);
+            r = t;
+        }
+        update(t);
+    }
+
+    template <class Alloc>
+    typename position_index<Alloc>::Entry* position_index<Alloc>::merge(Entry* a, Entry* b)
+    {
+        if (a == nullptr) {
+            return b;
+        }
+        if (b == nullptr) {
+            return a;
+        }
+        if (a->priority > b->priority) {
+            a->right = merge(a->right, b);
+            update(a);
+            return a;
+        }
+        b->left = merge(a, b->left);
+        update(b);
+        return b;
+    }
+
+    template <class Alloc>
+    template <class NextFn>
+    typename position_index<Alloc>::Entry* position_index<Alloc>::build(const void* first, size_t count, NextFn next)
+    {
+        // декартово дерево за O(count): правая ветка строящегося дерева хранится в стеке,
+        // все созданные вершины в любой момент образуют одно дерево с корнем result
+        std::vector<Entry*, typename std::allocator_traits<Alloc>::template rebind_alloc<Entry*>> stack(allocator);
+        Entry *result = nullptr;
+        try {
+            stack.reserve(64);
+            for (const void *key = first; count > 0; --count, key = next(key)) {
+                Entry *e = entry_traits::allocate(allocator, 1);
+                // Entry - агрегат, поэтому construct получает готовое значение, а не его поля
+                entry_traits::construct(allocator, e, Entry{nullptr, nullptr, nullptr, key, 1, static_cast<std::uint32_t>(random())});
+                try {
+                    entries.emplace(key, e);
+                } catch (...) {
+                    free_entry(e);
+                    throw;
+                }
+                Entry *last = nullptr;
+                while (!stack.empty() && stack.back()->priority < e->priority) {
+                    last = stack.back();
+                    stack.pop_back();
+                }
+                e->left = last;
+                if (!stack.empty()) {
+                    stack.back()->right = e;
+                }
+                else {
+                    result = e;
+                }
+                stack.push_back(e);
+            }
+            
+            // размеры и ссылки на родителей: вершины в порядке обхода, затем пересчет с конца (дети раньше)
+            stack.clear();
+            if (result != nullptr) {
+                stack.push_back(result);
+            }
+            for (size_t i = 0; i < stack.size(); ++i) {
+                if (stack[i]->left != nullptr) {
+                    stack.push_back(stack[i]->left);
+                }
+                if (stack[i]->right != nullptr) {
+                    stack.push_back(stack[i]->right);
+                }
+            }
+        } catch (...) {
+            destroy(result);
+            throw;
+        }
+        for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+            update(*it);
+        }
+        if (result != nullptr) {
+            result->parent = nullptr;
+        }
+        return result;
+    }
+
+    template <class Alloc>
+    void position_index<Alloc>::destroy(Entry* t) noexcept
+    {
+        while (t != nullptr) {
+            // срезаем левые поддеревья поворотами, чтобы обойтись без рекурсии и стека
+            if (t->left != nullptr) {
+                Entry *left = t->left;
+                t->left = left->right;
+                left->right = t;
+                t = left;
+            }
+            else {
+                Entry *right = t->right;
+                entries.erase(t->key);
+                free_entry(t);
+                t = right;
+            }
+        }
+    }
+
+    template <class Alloc>
+    void position_index<Alloc>::free_entry(Entry* e) noexcept
+    {
+        entry_traits::destroy(allocator, e);
+        entry_traits::deallocate(allocator, e, 1);
+    }
+
+    template <class Alloc>
+    position_index<Alloc>::position_index(const Alloc& alloc)
+        : allocator(alloc), entries(0, std::hash<const void*>(), std::equal_to<const void*>(), map_allocator_type(alloc)),
+          root(nullptr), random(), valid_(true)
+    {
+    }
+
+    template <class Alloc>
+    position_index<Alloc>::~position_index()
+    {
+        clear();
+    }
+
+    template <class Alloc>
+    void position_index<Alloc>::invalidate() noexcept
+    {
+        valid_ = false;
+    }
+
+    template <class Alloc>
+    void position_index<Alloc>::clear() noexcept
+    {
+        // все вершины есть в хеш-таблице: освобождаем их без обхода дерева
+        for (auto& entry : entries) {
+            free_entry(entry.second);
+        }
+        entries.clear();
+        root = nullptr;
+        valid_ = true;
+    }
+
+    template <class Alloc>
+    template <class NextFn>
+    void position_index<Alloc>::assign(const void* first, size_t count, NextFn next)
+    {
+        clear();
+        try {
+            entries.reserve(count);
+            root = build(first, count, next);
+        } catch (...) {
+            valid_ = false;
+            throw;
+        }
+    }
+
+    template <class Alloc>
+    template <class NextFn>
+    void position_index<Alloc>::insert(size_t position, const void* first, size_t count, NextFn next)
+    {
+        if (!valid_ || count == 0) {
+            return;
+        }
+        Entry *inserted;
+        try {
+            inserted = build(first, count, next);
+        } catch (...) {
+            // недостроенное дерево не вставляется; индекс будет перестроен при следующем запросе
+            valid_ = false;
+            throw;
+        }
+        Entry *l, *r;
+        split(root, position, l, r);
+        root = merge(merge(l, inserted), r);
+        root->parent = nullptr;
+    }
+
+    template <class Alloc>
+    void position_index<Alloc>::erase(size_t position, size_t count) noexcept
+    {
+        if (!valid_ || count == 0) {
+            return;
+        }
+        Entry *l, *middle, *r;
+        split(root, position, l, r);
+        split(r, count, middle, r);
+        if (middle != nullptr) {
+            middle->parent = nullptr;
+        }
+        destroy(middle);
+        root = merge(l, r);
+        if (root != nullptr) {
+            root->parent = nullptr;
+        }
+    }
+
+    template <class Alloc>
+    size_t position_index<Alloc>::rank(const void* key) const
+    {
+        const Entry *e = entries.find(key)->second;
+        size_t result = size_of(e->left);
+        for (; e->parent != nullptr; e = e->parent) {
+            if (e->parent->right == e) {
+                result += size_of(e->parent->left) + 1;
+            }
+        }
+        return result;
+    }
+
+    template <class Alloc>
+    const void* position_index<Alloc>::nth(size_t position) const
+    {
+        const Entry *e = root;
+        while (size_of(e->left) != position) {
+            if (position < size_of(e->left)) {
+                e = e->left;
+            }
+            else {
+                position -= size_of(e->left) + 1;
+                e = e->right;
+            }
+        }
+        return e->key;
+    }
+
+}  // namespace task
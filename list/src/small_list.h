@@ -0,0 +1,988 @@
+#pragma once
+#include <functional> // для std::less, std::equal_to
+#include <initializer_list>
+#include <iterator>
+#include <memory> // для allocator_traits
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "chain_sort.h"
+#include "list.h" // make_obj_using_allocator
+
+namespace task {
+
+// двусвязный список, первые N элементов которого живут в памяти самого объекта списка:
+// аллокатор вызывается, только когда во встроенной памяти не осталось свободного места.
+// Свободные встроенные места образуют стек, поэтому место удаленного элемента сразу
+// используется повторно. Итераторы и ссылки ведут себя как у task::list, кроме случаев,
+// когда встроенный элемент покидает объект списка:
+// - перемещение и swap списков переносят встроенные элементы во встроенную память
+//   другого объекта (перемещением T): итераторы на них становятся недействительными;
+// - splice и merge из другого списка копируют встроенные элементы other в элементы
+//   этого списка (перемещением T) - не более N перемещений, остальные элементы
+//   переносятся перестановкой указателей. Итератор на перенесенный встроенный элемент
+//   становится недействительным, splice одного элемента возвращает итератор на него
+//   в этом списке. Перенос внутри одного списка ничего не копирует.
+// Аллокаторы списков при splice и merge должны быть равны, как у task::list
+template<class T, size_t N = 8, class Alloc = std::allocator<T>>
+class small_list {
+    static_assert(N > 0, "small_list inline capacity must be positive");
+
+private:
+    class BaseNode { // связи элемента, без данных
+    public:
+        BaseNode *next;
+        BaseNode *prev; // у свободного встроенного места prev == nullptr
+        BaseNode() noexcept : next(this), prev(this) {};
+        BaseNode(BaseNode* n, BaseNode* p) noexcept : next(n), prev(p) {};
+    };
+    class Node : public BaseNode {
+    public:
+        T data;
+        template <class... Args>
+        Node(BaseNode* n, BaseNode* p, Args&&... args) : BaseNode(n, p), data(std::forward<Args>(args)...) {};
+
+        // конструирование с аллокатором, как у элементов task::list
+        using allocator_type = Alloc;
+        template <class... Args>
+        Node(std::allocator_arg_t, const Alloc& alloc, BaseNode* n, BaseNode* p, Args&&... args)
+            : BaseNode(n, p), data(make_obj_using_allocator<T>(alloc, std::forward<Args>(args)...)) {};
+    };
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<allocator_type>;
+    allocator_type allocator;
+    BaseNode head; // фиктивный элемент: head.next - первый, head.prev - последний
+    size_t size_;
+
+    struct Slot {
+        alignas(Node) unsigned char bytes[sizeof(Node)];
+    };
+    Slot slots[N]; // встроенная память: в каждом месте либо Node, либо BaseNode стека свободных мест
+    BaseNode *free_slots; // вершина стека свободных мест или nullptr
+
+    BaseNode* slot(size_t i) noexcept { return reinterpret_cast<BaseNode*>(slots[i].bytes); }
+    bool is_inline(const BaseNode* node) const noexcept;
+    // все встроенные места свободны
+    void reset_slots() noexcept;
+
+    static T& value(BaseNode* node) { return static_cast<Node*>(node)->data; }
+
+    // память под элемент: свободное встроенное место или аллокатор
+    Node* allocate_node();
+    void deallocate_node(Node* node) noexcept;
+    template <class... Args>
+    Node* create_node(BaseNode* next, BaseNode* prev, Args&&... args);
+    void destroy_node(Node* node) noexcept;
+
+    // включение элемента перед pos и исключение элемента из списка, без изменения size_
+    static void link_before(BaseNode* pos, BaseNode* node) noexcept;
+    static void unlink(BaseNode* node) noexcept;
+
+    // встроенные элементы other заменяются на месте элементами этого списка с перемещенными
+    // значениями: после этого все элементы other можно переносить перестановкой указателей
+    void adopt_inline(small_list& other);
+    // встроенный элемент other заменяется элементом этого списка; возвращается новый элемент
+    Node* adopt_node(small_list& other, BaseNode* node);
+    // перенос всех элементов other в пустой список с равным аллокатором
+    void steal(small_list& other);
+    // присваивание значений [first, last) существующим элементам, создание недостающих и удаление лишних
+    template <class InputIt>
+    void assign_elements(InputIt first, InputIt last);
+
+    // восстановление prev и кольца после работы с цепочкой через next
+    void relink_prev(BaseNode* first) noexcept;
+
+    template <class InputIt>
+    using RequireInputIter = std::enable_if_t<std::is_convertible<
+        typename std::iterator_traits<InputIt>::iterator_category, std::input_iterator_tag>::value>;
+
+public:
+    class iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        iterator() : ptr(nullptr) {};
+
+        iterator& operator++() { ptr = ptr->next; return *this; }
+        iterator operator++(int) { iterator it = *this; ptr = ptr->next; return it; }
+        iterator& operator--() { ptr = ptr->prev; return *this; }
+        iterator operator--(int) { iterator it = *this; ptr = ptr->prev; return it; }
+        reference operator*() const { return value(ptr); }
+        pointer operator->() const { return &value(ptr); }
+
+        bool operator==(iterator other) const { return ptr == other.ptr; }
+        bool operator!=(iterator other) const { return ptr != other.ptr; }
+
+        friend class small_list;
+    private:
+        BaseNode *ptr;
+    };
+
+    class const_iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() : ptr(nullptr) {};
+        const_iterator(const iterator& it) : ptr(it.ptr) {};
+
+        const_iterator& operator++() { ptr = ptr->next; return *this; }
+        const_iterator operator++(int) { const_iterator it = *this; ptr = ptr->next; return it; }
+        const_iterator& operator--() { ptr = ptr->prev; return *this; }
+        const_iterator operator--(int) { const_iterator it = *this; ptr = ptr->prev; return it; }
+        reference operator*() const { return static_cast<const Node*>(ptr)->data; }
+        pointer operator->() const { return &static_cast<const Node*>(ptr)->data; }
+
+        bool operator==(const_iterator other) const { return ptr == other.ptr; }
+        bool operator!=(const_iterator other) const { return ptr != other.ptr; }
+
+        friend class small_list;
+    private:
+        const BaseNode *ptr;
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    small_list() noexcept(noexcept(Alloc()));
+    explicit small_list(const Alloc& alloc) noexcept;
+    small_list(size_t count, const T& value, const Alloc& alloc = Alloc());
+    explicit small_list(size_t count, const Alloc& alloc = Alloc());
+    template <class InputIt, class = RequireInputIter<InputIt>>
+    small_list(InputIt first, InputIt last, const Alloc& alloc = Alloc());
+    small_list(std::initializer_list<T> ilist, const Alloc& alloc = Alloc());
+
+    // копия получает аллокатор select_on_container_copy_construction(other.get_allocator())
+    small_list(const small_list& other);
+    small_list(const small_list& other, const Alloc& alloc);
+    // элементы из памяти аллокатора переходят без копирования, встроенные - перемещаются по одному
+    small_list(small_list&& other);
+    small_list(small_list&& other, const Alloc& alloc);
+    small_list& operator=(const small_list& other);
+    small_list& operator=(small_list&& other);
+
+    ~small_list();
+
+    Alloc get_allocator() const;
+    // количество элементов, которые помещаются в объект списка
+    static constexpr size_t inline_capacity() { return N; }
+    // true, если элемент живет во встроенной памяти списка
+    bool is_inline(const_iterator pos) const;
+
+    T& front();
+    const T& front() const;
+    T& back();
+    const T& back() const;
+
+    iterator begin();
+    iterator end();
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+    bool empty() const;
+    size_t size() const;
+    size_t max_size() const;
+    void clear();
+
+    iterator insert(const_iterator pos, const T& value);
+    iterator insert(const_iterator pos, T&& value);
+    iterator insert(const_iterator pos, size_t count, const T& value);
+    template <class InputIt, class = RequireInputIter<InputIt>>
+    iterator insert(const_iterator pos, InputIt first, InputIt last);
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+    template <class... Args>
+    void emplace_back(Args&&... args);
+    void pop_back();
+
+    void push_front(const T& value);
+    void push_front(T&& value);
+    template <class... Args>
+    void emplace_front(Args&&... args);
+    void pop_front();
+
+    void swap(small_list& other);
+
+    // перенос всех элементов other перед pos
+    void splice(const_iterator pos, small_list& other);
+    // перенос элемента it; возвращает итератор на элемент в этом списке
+    iterator splice(const_iterator pos, small_list& other, const_iterator it);
+    // перенос элементов [first, last), O(last - first) при other != *this
+    void splice(const_iterator pos, small_list& other, const_iterator first, const_iterator last);
+
+    void merge(small_list& other);
+    template <class Compare>
+    void merge(small_list& other, Compare comp);
+    size_t remove(const T& value);
+    template <class UnaryPredicate>
+    size_t remove_if(UnaryPredicate pred);
+    void reverse() noexcept;
+    size_t unique();
+    template <class BinaryPredicate>
+    size_t unique(BinaryPredicate pred);
+    // устойчивая сортировка слиянием: только перестановка указателей, без выделения памяти
+    void sort();
+    template <class Compare>
+    void sort(Compare comp);
+};
+
+namespace pmr {
+    template <class T, size_t N = 8>
+    using small_list = task::small_list<T, N, std::pmr::polymorphic_allocator<T>>;
+}  // namespace pmr
+
+    template <class T, size_t N, class Alloc>
+    bool small_list<T, N, Alloc>::is_inline(const BaseNode* node) const noexcept
+    {
+        const void *p = node;
+        return !std::less<const void*>()(p, slots[0].bytes) && std::less<const void*>()(p, slots + N);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::reset_slots() noexcept
+    {
+        free_slots = nullptr;
+        for (size_t i = N; i > 0; --i) {
+            free_slots = new (slots[i - 1].bytes) BaseNode(free_slots, nullptr);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::Node* small_list<T, N, Alloc>::allocate_node()
+    {
+        if (free_slots != nullptr) {
+            // место начинается с BaseNode стека свободных мест, Node строится поверх него
+            void *p = free_slots;
+            free_slots = free_slots->next;
+            return static_cast<Node*>(p);
+        }
+        return node_traits::allocate(allocator, 1);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::deallocate_node(Node* node) noexcept
+    {
+        if (is_inline(node)) {
+            free_slots = new (static_cast<void*>(node)) BaseNode(free_slots, nullptr);
+        }
+        else {
+            node_traits::deallocate(allocator, node, 1);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class... Args>
+    typename small_list<T, N, Alloc>::Node* small_list<T, N, Alloc>::create_node(BaseNode* next, BaseNode* prev, Args&&... args)
+    {
+        Node *node = allocate_node();
+        try {
+            node_traits::construct(allocator, node, next, prev, std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_node(node);
+            throw;
+        }
+        return node;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::destroy_node(Node* node) noexcept
+    {
+        node_traits::destroy(allocator, node);
+        deallocate_node(node);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::link_before(BaseNode* pos, BaseNode* node) noexcept
+    {
+        node->next = pos;
+        node->prev = pos->prev;
+        pos->prev->next = node;
+        pos->prev = node;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::unlink(BaseNode* node) noexcept
+    {
+        node->prev->next = node->next;
+        node->next->prev = node->prev;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::Node* small_list<T, N, Alloc>::adopt_node(small_list& other, BaseNode* node)
+    {
+        // новый элемент встает на место старого в списке other
+        Node *copy = create_node(node->next, node->prev, std::move(value(node)));
+        node->prev->next = copy;
+        node->next->prev = copy;
+        other.destroy_node(static_cast<Node*>(node));
+        return copy;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::adopt_inline(small_list& other)
+    {
+        // обход встроенных мест, а не списка: O(N) независимо от размера other
+        for (size_t i = 0; i < N; ++i) {
+            BaseNode *node = other.slot(i);
+            if (node->prev != nullptr) {
+                adopt_node(other, node);
+            }
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::steal(small_list& other)
+    {
+        adopt_inline(other);
+        if (other.size_ > 0) {
+            head.next = other.head.next;
+            head.prev = other.head.prev;
+            head.next->prev = &head;
+            head.prev->next = &head;
+            size_ = other.size_;
+            other.head.next = other.head.prev = &other.head;
+            other.size_ = 0;
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class InputIt>
+    void small_list<T, N, Alloc>::assign_elements(InputIt first, InputIt last)
+    {
+        // присваиваем значения уже существующим элементам, память выделяем только для недостающих
+        BaseNode *node = head.next;
+        for (; node != &head && first != last; node = node->next, ++first) {
+            value(node) = *first;
+        }
+        const_iterator pos;
+        pos.ptr = node;
+        if (first == last) {
+            erase(pos, cend());
+        }
+        else {
+            insert(pos, first, last);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::relink_prev(BaseNode* first) noexcept
+    {
+        BaseNode *prev = &head;
+        for (BaseNode *node = first; node != nullptr; node = node->next) {
+            prev->next = node;
+            node->prev = prev;
+            prev = node;
+        }
+        prev->next = &head;
+        head.prev = prev;
+    }
+
+    // конструкторы пустого списка не выделяют память
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list() noexcept(noexcept(Alloc()))
+        : allocator(), head(), size_(0)
+    {
+        reset_slots();
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(const Alloc& alloc) noexcept
+        : allocator(alloc), head(), size_(0)
+    {
+        reset_slots();
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(size_t count, const T& value, const Alloc& alloc) : small_list(alloc)
+    {
+        insert(cend(), count, value);
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(size_t count, const Alloc& alloc) : small_list(alloc)
+    {
+        for (; count > 0; --count) {
+            emplace_back();
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class InputIt, class>
+    small_list<T, N, Alloc>::small_list(InputIt first, InputIt last, const Alloc& alloc) : small_list(alloc)
+    {
+        insert(cend(), first, last);
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(std::initializer_list<T> ilist, const Alloc& alloc) : small_list(alloc)
+    {
+        insert(cend(), ilist.begin(), ilist.end());
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(const small_list& other)
+        : small_list(other, std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+    {
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(const small_list& other, const Alloc& alloc) : small_list(alloc)
+    {
+        insert(cend(), other.cbegin(), other.cend());
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(small_list&& other) : small_list(Alloc(other.allocator))
+    {
+        steal(other);
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::small_list(small_list&& other, const Alloc& alloc) : small_list(alloc)
+    {
+        if (allocator == other.allocator) {
+            steal(other);
+        }
+        else {
+            insert(cend(), std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>& small_list<T, N, Alloc>::operator=(const small_list& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+            // элементы освобождаются тем аллокатором, которым были выделены
+            if (allocator != other.allocator) {
+                clear();
+            }
+            allocator = other.allocator;
+        }
+        assign_elements(other.cbegin(), other.cend());
+        return *this;
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>& small_list<T, N, Alloc>::operator=(small_list&& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        if constexpr (node_traits::propagate_on_container_move_assignment::value) {
+            clear();
+            allocator = std::move(other.allocator);
+            steal(other);
+        }
+        else if (allocator == other.allocator) {
+            clear();
+            steal(other);
+        }
+        else {
+            assign_elements(std::make_move_iterator(other.begin()), std::make_move_iterator(other.end()));
+        }
+        return *this;
+    }
+
+    template <class T, size_t N, class Alloc>
+    small_list<T, N, Alloc>::~small_list()
+    {
+        clear();
+    }
+
+    template <class T, size_t N, class Alloc>
+    Alloc small_list<T, N, Alloc>::get_allocator() const
+    {
+        return Alloc(allocator);
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool small_list<T, N, Alloc>::is_inline(const_iterator pos) const
+    {
+        return is_inline(pos.ptr);
+    }
+
+    template <class T, size_t N, class Alloc>
+    T& small_list<T, N, Alloc>::front()
+    {
+        return value(head.next);
+    }
+
+    template <class T, size_t N, class Alloc>
+    const T& small_list<T, N, Alloc>::front() const
+    {
+        return static_cast<const Node*>(head.next)->data;
+    }
+
+    template <class T, size_t N, class Alloc>
+    T& small_list<T, N, Alloc>::back()
+    {
+        return value(head.prev);
+    }
+
+    template <class T, size_t N, class Alloc>
+    const T& small_list<T, N, Alloc>::back() const
+    {
+        return static_cast<const Node*>(head.prev)->data;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::begin()
+    {
+        iterator it;
+        it.ptr = head.next;
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::end()
+    {
+        iterator it;
+        it.ptr = &head;
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::const_iterator small_list<T, N, Alloc>::cbegin() const
+    {
+        const_iterator it;
+        it.ptr = head.next;
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::const_iterator small_list<T, N, Alloc>::cend() const
+    {
+        const_iterator it;
+        it.ptr = &head;
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::reverse_iterator small_list<T, N, Alloc>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::reverse_iterator small_list<T, N, Alloc>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::const_reverse_iterator small_list<T, N, Alloc>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::const_reverse_iterator small_list<T, N, Alloc>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    template <class T, size_t N, class Alloc>
+    bool small_list<T, N, Alloc>::empty() const
+    {
+        return size_ == 0;
+    }
+
+    template <class T, size_t N, class Alloc>
+    size_t small_list<T, N, Alloc>::size() const
+    {
+        return size_;
+    }
+
+    template <class T, size_t N, class Alloc>
+    size_t small_list<T, N, Alloc>::max_size() const
+    {
+        return node_traits::max_size(allocator);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::clear()
+    {
+        BaseNode *node = head.next;
+        while (node != &head) {
+            Node *to_del = static_cast<Node*>(node);
+            node = node->next;
+            destroy_node(to_del);
+        }
+        head.next = head.prev = &head;
+        size_ = 0;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator
+    small_list<T, N, Alloc>::insert(const_iterator pos, size_t count, const T& value)
+    {
+        iterator it;
+        it.ptr = const_cast<BaseNode*>(pos.ptr);
+        for (size_t i = 0; i < count; ++i) {
+            iterator inserted = emplace(pos, value);
+            if (i == 0) {
+                it = inserted;
+            }
+        }
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class InputIt, class>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::insert(const_iterator pos, InputIt first, InputIt last)
+    {
+        iterator it;
+        it.ptr = const_cast<BaseNode*>(pos.ptr);
+        bool is_first = true;
+        for (; first != last; ++first) {
+            iterator inserted = emplace(pos, *first);
+            if (is_first) {
+                it = inserted;
+                is_first = false;
+            }
+        }
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class... Args>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::emplace(const_iterator pos, Args&&... args)
+    {
+        BaseNode *next = const_cast<BaseNode*>(pos.ptr);
+        Node *node = create_node(next, next->prev, std::forward<Args>(args)...);
+        next->prev->next = node;
+        next->prev = node;
+        ++size_;
+        iterator it;
+        it.ptr = node;
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::erase(const_iterator pos)
+    {
+        BaseNode *node = const_cast<BaseNode*>(pos.ptr);
+        iterator it;
+        it.ptr = node->next;
+        unlink(node);
+        destroy_node(static_cast<Node*>(node));
+        --size_;
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator small_list<T, N, Alloc>::erase(const_iterator first, const_iterator last)
+    {
+        while (first != last) {
+            first = erase(first);
+        }
+        iterator it;
+        it.ptr = const_cast<BaseNode*>(last.ptr);
+        return it;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::push_back(const T& value)
+    {
+        emplace(cend(), value);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::push_back(T&& value)
+    {
+        emplace(cend(), std::move(value));
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class... Args>
+    void small_list<T, N, Alloc>::emplace_back(Args&&... args)
+    {
+        emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::pop_back()
+    {
+        const_iterator it;
+        it.ptr = head.prev;
+        erase(it);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::push_front(const T& value)
+    {
+        emplace(cbegin(), value);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::push_front(T&& value)
+    {
+        emplace(cbegin(), std::move(value));
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class... Args>
+    void small_list<T, N, Alloc>::emplace_front(Args&&... args)
+    {
+        emplace(cbegin(), std::forward<Args>(args)...);
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::pop_front()
+    {
+        erase(cbegin());
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::swap(small_list& other)
+    {
+        if (this == &other) {
+            return;
+        }
+        // обмен через временный список: встроенные элементы переходят во встроенную память другого объекта
+        small_list tmp((Alloc(allocator)));
+        tmp.steal(other);
+        other.steal(*this);
+        steal(tmp);
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator, other.allocator);
+        }
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::splice(const_iterator pos, small_list& other)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        adopt_inline(other);
+        BaseNode *next = const_cast<BaseNode*>(pos.ptr);
+        BaseNode *first = other.head.next, *last = other.head.prev;
+        first->prev = next->prev;
+        last->next = next;
+        next->prev->next = first;
+        next->prev = last;
+        size_ += other.size_;
+        other.head.next = other.head.prev = &other.head;
+        other.size_ = 0;
+    }
+
+    template <class T, size_t N, class Alloc>
+    typename small_list<T, N, Alloc>::iterator
+    small_list<T, N, Alloc>::splice(const_iterator pos, small_list& other, const_iterator it)
+    {
+        BaseNode *next = const_cast<BaseNode*>(pos.ptr);
+        BaseNode *node = const_cast<BaseNode*>(it.ptr);
+        iterator result;
+        result.ptr = node;
+        if (node == next || node->next == next) {
+            return result;
+        }
+        if (this != &other) {
+            if (other.is_inline(node)) {
+                result.ptr = node = adopt_node(other, node);
+            }
+            --other.size_;
+            ++size_;
+        }
+        unlink(node);
+        link_before(next, node);
+        return result;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::splice(const_iterator pos, small_list& other, const_iterator first, const_iterator last)
+    {
+        BaseNode *next = const_cast<BaseNode*>(pos.ptr);
+        BaseNode *begin = const_cast<BaseNode*>(first.ptr);
+        BaseNode *stop = const_cast<BaseNode*>(last.ptr);
+        if (begin == stop || begin == next) {
+            return;
+        }
+        if (this != &other) {
+            // встроенные элементы диапазона заменяются элементами этого списка прямо в other
+            size_t count = 0;
+            for (BaseNode *node = begin; node != stop; node = node->next, ++count) {
+                if (other.is_inline(node)) {
+                    node = adopt_node(other, node);
+                    if (count == 0) {
+                        begin = node;
+                    }
+                }
+            }
+            other.size_ -= count;
+            size_ += count;
+        }
+        BaseNode *end = stop->prev;
+        begin->prev->next = stop;
+        stop->prev = begin->prev;
+        begin->prev = next->prev;
+        end->next = next;
+        next->prev->next = begin;
+        next->prev = end;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::merge(small_list& other)
+    {
+        merge(other, std::less<T>());
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class Compare>
+    void small_list<T, N, Alloc>::merge(small_list& other, Compare comp)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        adopt_inline(other);
+        head.prev->next = nullptr;
+        other.head.prev->next = nullptr;
+        BaseNode *a = (size_ > 0) ? head.next : nullptr;
+        BaseNode *b = other.head.next;
+        // при исключении из comp все элементы тоже переходят в этот список, в неопределенном порядке
+        auto finish = [this, &other, &a]() {
+            relink_prev(a);
+            size_ += other.size_;
+            other.head.next = other.head.prev = &other.head;
+            other.size_ = 0;
+        };
+        auto less = [&comp](BaseNode* x, BaseNode* y) { return comp(value(x), value(y)); };
+        try {
+            merge_chains(a, b, less);
+        }
+        catch (...) {
+            finish();
+            throw;
+        }
+        finish();
+    }
+
+    template <class T, size_t N, class Alloc>
+    size_t small_list<T, N, Alloc>::remove(const T& value)
+    {
+        // value может быть ссылкой на элемент списка: сравниваем с копией
+        T copy = value;
+        return remove_if([&copy](const T& x) { return x == copy; });
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class UnaryPredicate>
+    size_t small_list<T, N, Alloc>::remove_if(UnaryPredicate pred)
+    {
+        size_t count = 0;
+        for (BaseNode *node = head.next; node != &head;) {
+            BaseNode *next = node->next;
+            if (pred(value(node))) {
+                unlink(node);
+                destroy_node(static_cast<Node*>(node));
+                --size_;
+                ++count;
+            }
+            node = next;
+        }
+        return count;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::reverse() noexcept
+    {
+        BaseNode *node = &head;
+        do {
+            std::swap(node->next, node->prev);
+            node = node->prev;
+        } while (node != &head);
+    }
+
+    template <class T, size_t N, class Alloc>
+    size_t small_list<T, N, Alloc>::unique()
+    {
+        return unique(std::equal_to<T>());
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class BinaryPredicate>
+    size_t small_list<T, N, Alloc>::unique(BinaryPredicate pred)
+    {
+        if (size_ < 2) {
+            return 0;
+        }
+        size_t count = 0;
+        BaseNode *kept = head.next;
+        while (kept->next != &head) {
+            BaseNode *node = kept->next;
+            if (pred(value(kept), value(node))) {
+                unlink(node);
+                destroy_node(static_cast<Node*>(node));
+                --size_;
+                ++count;
+            }
+            else {
+                kept = node;
+            }
+        }
+        return count;
+    }
+
+    template <class T, size_t N, class Alloc>
+    void small_list<T, N, Alloc>::sort()
+    {
+        sort(std::less<T>());
+    }
+
+    template <class T, size_t N, class Alloc>
+    template <class Compare>
+    void small_list<T, N, Alloc>::sort(Compare comp)
+    {
+        if (size_ < 2) {
+            return;
+        }
+        // сортировка слиянием снизу вверх по цепочке next, затем восстановление prev
+        head.prev->next = nullptr;
+        BaseNode *chain = head.next;
+        auto less = [&comp](BaseNode* a, BaseNode* b) { return comp(value(a), value(b)); };
+        try {
+            sort_chain(chain, less);
+        }
+        catch (...) {
+            relink_prev(chain);
+            throw;
+        }
+        relink_prev(chain);
+    }
+
+}  // namespace task
@@ -0,0 +1,1029 @@
+#pragma once
+#include <algorithm>
+#include <functional> // для std::less, std::equal_to
+#include <iterator>
+#include <memory> // для allocator_traits
+#include <utility>
+#include <vector>
+#include "list.h" // make_obj_using_allocator
+
+namespace task {
+
+// развернутый список: каждый блок хранит подряд до K значений, поэтому обход затрагивает
+// одну строку кэша на несколько элементов, а два указателя делятся между K значениями.
+// Интерфейс повторяет task::list, но значения живут внутри блоков и сдвигаются при вставке
+// и удалении: итераторы и ссылки на значения того же блока (а при делении или слиянии блоков -
+// и соседнего) становятся недействительными. merge и sort перемещают значения, а не блоки.
+template<class T, class Alloc = std::allocator<T>, size_t K = (sizeof(T) >= 64 ? 4 : 256 / sizeof(T))>
+class unrolled_list {
+    static_assert(K > 0, "unrolled_list block capacity must be positive");
+
+private:
+    class BaseNode { // связи блока, без данных
+    public:
+        BaseNode *next; // указатель на следующий блок
+        BaseNode *prev; // указатель на предыдущий блок
+        BaseNode() noexcept : next(this), prev(this) {};
+        BaseNode(BaseNode* n, BaseNode* p) noexcept : next(n), prev(p) {};
+    };
+    class Block : public BaseNode { // блок из count значений, count от 1 до K
+    public:
+        size_t count; // количество значений в блоке
+        alignas(T) unsigned char storage[sizeof(T) * K]; // память под значения, конструируются по мере вставки
+        Block(BaseNode* n, BaseNode* p) noexcept : BaseNode(n, p), count(0) {};
+        T* data() { return reinterpret_cast<T*>(storage); }
+        const T* data() const { return reinterpret_cast<const T*>(storage); }
+    };
+    // аллокатор для типа Block
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Block>;
+    using block_traits = std::allocator_traits<allocator_type>;
+    allocator_type allocator;
+    BaseNode head; // граница списка: head.next - первый блок, head.prev - последний
+    size_t size_; // количество значений
+
+    // аллокатор для значений: через него значения создаются в памяти блока, поэтому
+    // pmr-аллокатор передается значениям (uses-allocator construction), как в task::list
+    using value_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+    using value_traits = std::allocator_traits<value_allocator_type>;
+
+    static Block* block(BaseNode* node) { return static_cast<Block*>(node); }
+    static const Block* block(const BaseNode* node) { return static_cast<const Block*>(node); }
+
+    // создание значения по адресу p в памяти блока и его уничтожение
+    template <class... Args>
+    void construct_value(T* p, Args&&... args);
+    void destroy_value(T* p) noexcept;
+    // временное значение, созданное с аллокатором списка
+    template <class... Args>
+    T make_value(Args&&... args) const;
+
+    // новый пустой блок, еще не включенный в список, и его освобождение
+    Block* allocate_block();
+    void deallocate_block(Block* b) noexcept;
+    // включение блока b между prev и next
+    void link_block(Block* b, BaseNode* next, BaseNode* prev) noexcept;
+    // новый блок из одного значения между prev и next; блок включается в список,
+    // только если значение создано, иначе память блока освобождается
+    template <class... Args>
+    Block* create_block(BaseNode* next, BaseNode* prev, Args&&... args);
+    // уничтожение значений блока, исключение его из списка и освобождение памяти
+    void destroy_block(Block* b) noexcept;
+    // перенос значений [index, count) блока b в новый блок сразу после него
+    Block* split_block(Block* b, size_t index);
+    // перенос всех значений следующего блока в конец b, если b заполнен меньше чем наполовину
+    // и значения помещаются; возвращает true, если блоки слиты.
+    // Если перемещение T бросает исключение, оба блока остаются без изменений
+    bool try_merge_next(Block* b);
+    // вставка значения в позицию index блока b (index <= count); при переполнении блок делится;
+    // возвращает блок и позицию вставленного значения
+    template <class... Args>
+    std::pair<Block*, size_t> emplace_in_block(Block* b, size_t index, Args&&... args);
+    // удаление значения из позиции index блока b; возвращает позицию следующего значения
+    std::pair<BaseNode*, size_t> erase_in_block(Block* b, size_t index);
+
+    // перемещение всех значений в буфер (для merge и sort)
+    using buffer_type = std::vector<T, value_allocator_type>;
+    void move_to(buffer_type& buffer);
+    // обмен цепочками блоков и размерами, аллокаторы не меняются
+    void swap_blocks(unrolled_list& other) noexcept;
+
+public:
+    class const_iterator;
+
+    class iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        iterator() : node(nullptr), index(0) {}
+
+        iterator& operator++() {
+            if (++index == block(node)->count) {
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+        reference operator*() const { return block(node)->data()[index]; }
+        pointer operator->() const { return &block(node)->data()[index]; }
+        iterator& operator--() {
+            if (index == 0) {
+                node = node->prev;
+                index = block(node)->count;
+            }
+            --index;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(iterator other) const { return node == other.node && index == other.index; }
+        bool operator!=(iterator other) const { return !(*this == other); }
+
+        friend class unrolled_list;
+        friend class const_iterator;
+    private:
+        iterator(BaseNode* n, size_t i) : node(n), index(i) {}
+        BaseNode *node; // блок
+        size_t index; // позиция значения в блоке, у end() - 0
+    };
+
+    class const_iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() : node(nullptr), index(0) {}
+        const_iterator(const iterator& other) : node(other.node), index(other.index) {}
+
+        const_iterator& operator++() {
+            if (++index == block(node)->count) {
+                node = node->next;
+                index = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++*this;
+            return it;
+        }
+        reference operator*() const { return block(node)->data()[index]; }
+        pointer operator->() const { return &block(node)->data()[index]; }
+        const_iterator& operator--() {
+            if (index == 0) {
+                node = node->prev;
+                index = block(node)->count;
+            }
+            --index;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const_iterator other) const { return node == other.node && index == other.index; }
+        bool operator!=(const_iterator other) const { return !(*this == other); }
+
+        friend class unrolled_list;
+    private:
+        const_iterator(const BaseNode* n, size_t i) : node(n), index(i) {}
+        const BaseNode *node;
+        size_t index;
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+
+    unrolled_list() noexcept(noexcept(Alloc()));
+    explicit unrolled_list(const Alloc& alloc) noexcept;
+    unrolled_list(size_t count, const T& value, const Alloc& alloc = Alloc());
+    explicit unrolled_list(size_t count, const Alloc& alloc = Alloc());
+
+    ~unrolled_list();
+
+    // копия получает аллокатор select_on_container_copy_construction(other.get_allocator())
+    unrolled_list(const unrolled_list& other);
+    unrolled_list(unrolled_list&& other) noexcept;
+    // аллокатор заменяется по propagate_on_container_copy_assignment
+    unrolled_list& operator=(const unrolled_list& other);
+    // аллокатор заменяется по propagate_on_container_move_assignment; если он не заменяется и
+    // аллокаторы не равны, значения other перемещаются по одному в блоки этого списка
+    unrolled_list& operator=(unrolled_list&& other) noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                                                             std::allocator_traits<Alloc>::is_always_equal::value);
+
+    Alloc get_allocator() const;
+
+
+    T& front();
+    const T& front() const;
+
+    T& back();
+    const T& back() const;
+
+
+    iterator begin();
+    iterator end();
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+
+    bool empty() const;
+    size_t size() const;
+    size_t max_size() const;
+    void clear();
+
+    iterator insert(const_iterator pos, const T& value);
+    iterator insert(const_iterator pos, T&& value);
+    iterator insert(const_iterator pos, size_t count, const T& value);
+
+    iterator erase(const_iterator pos);
+    iterator erase(const_iterator first, const_iterator last);
+
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+    void pop_back();
+
+    void push_front(const T& value);
+    void push_front(T&& value);
+    void pop_front();
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+
+    template <class... Args>
+    void emplace_back(Args&&... args);
+
+    template <class... Args>
+    void emplace_front(Args&&... args);
+
+    void resize(size_t count);
+    // аллокаторы обмениваются по propagate_on_container_swap, иначе они должны быть равны
+    void swap(unrolled_list& other);
+
+
+    void merge(unrolled_list& other);
+    template <class Compare>
+    void merge(unrolled_list& other, Compare comp);
+    void splice(const_iterator pos, unrolled_list& other);
+    size_t remove(const T& value);
+    template <class UnaryPredicate>
+    size_t remove_if(UnaryPredicate pred);
+    void reverse();
+    size_t unique();
+    template <class BinaryPredicate>
+    size_t unique(BinaryPredicate pred);
+    void sort();
+    template <class Compare>
+    void sort(Compare comp);
+};
+
+    // работа с блоками
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    void unrolled_list<T, Alloc, K>::construct_value(T* p, Args&&... args)
+    {
+        value_allocator_type alloc(allocator);
+        value_traits::construct(alloc, p, std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::destroy_value(T* p) noexcept
+    {
+        value_allocator_type alloc(allocator);
+        value_traits::destroy(alloc, p);
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    T unrolled_list<T, Alloc, K>::make_value(Args&&... args) const
+    {
+        return make_obj_using_allocator<T>(value_allocator_type(allocator), std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::Block* unrolled_list<T, Alloc, K>::allocate_block()
+    {
+        Block *b = block_traits::allocate(allocator, 1);
+        block_traits::construct(allocator, b, nullptr, nullptr);
+        return b;
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::deallocate_block(Block* b) noexcept
+    {
+        block_traits::destroy(allocator, b);
+        block_traits::deallocate(allocator, b, 1);
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::link_block(Block* b, BaseNode* next, BaseNode* prev) noexcept
+    {
+        b->next = next;
+        b->prev = prev;
+        next->prev = b;
+        prev->next = b;
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    typename unrolled_list<T, Alloc, K>::Block* unrolled_list<T, Alloc, K>::create_block(BaseNode* next, BaseNode* prev, Args&&... args)
+    {
+        Block *b = allocate_block();
+        try {
+            construct_value(b->data(), std::forward<Args>(args)...);
+        } catch (...) {
+            deallocate_block(b);
+            throw;
+        }
+        b->count = 1;
+        ++size_;
+        link_block(b, next, prev);
+        return b;
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::destroy_block(Block* b) noexcept
+    {
+        T *d = b->data();
+        for (size_t i = 0; i < b->count; ++i) {
+            destroy_value(d + i);
+        }
+        size_ -= b->count;
+        b->prev->next = b->next;
+        b->next->prev = b->prev;
+        block_traits::destroy(allocator, b);
+        block_traits::deallocate(allocator, b, 1);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::Block* unrolled_list<T, Alloc, K>::split_block(Block* b, size_t index)
+    {
+        // новый блок включается в список только после переноса всех значений
+        Block *nb = allocate_block();
+        T *from = b->data(), *to = nb->data();
+        size_t i = index;
+        try {
+            for (; i < b->count; ++i) {
+                construct_value(to + (i - index), std::move(from[i]));
+            }
+        } catch (...) {
+            for (size_t j = index; j < i; ++j) {
+                destroy_value(to + (j - index));
+            }
+            deallocate_block(nb);
+            throw;
+        }
+        for (i = index; i < b->count; ++i) {
+            destroy_value(from + i);
+        }
+        nb->count = b->count - index;
+        b->count = index;
+        link_block(nb, b->next, b);
+        return nb;
+    }
+
+    template <class T, class Alloc, size_t K>
+    bool unrolled_list<T, Alloc, K>::try_merge_next(Block* b)
+    {
+        if (b->next == &head || b->count >= K / 2 || b->count + block(b->next)->count > K) {
+            return false;
+        }
+        Block *nb = block(b->next);
+        T *from = nb->data(), *to = b->data();
+        size_t i = 0;
+        try {
+            for (; i < nb->count; ++i) {
+                construct_value(to + b->count + i, std::move(from[i]));
+            }
+        } catch (...) {
+            for (size_t j = 0; j < i; ++j) {
+                destroy_value(to + b->count + j);
+            }
+            throw;
+        }
+        b->count += nb->count;
+        size_ += nb->count; // destroy_block вычтет значения nb из размера
+        destroy_block(nb);
+        return true;
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    std::pair<typename unrolled_list<T, Alloc, K>::Block*, size_t>
+    unrolled_list<T, Alloc, K>::emplace_in_block(Block* b, size_t index, Args&&... args)
+    {
+        if (b->count == K) {
+            if (index == K) { // добавление в конец полного блока: новый блок после него
+                return {create_block(b->next, b, std::forward<Args>(args)...), 0};
+            }
+            if (index == 0) { // добавление в начало полного блока: новый блок перед ним
+                return {create_block(b, b->prev, std::forward<Args>(args)...), 0};
+            }
+            // вставка в середину: делим блок пополам. Значение создается до деления:
+            // при исключении блок не меняется, а аргументы могут ссылаться на его значения
+            T value = make_value(std::forward<Args>(args)...);
+            Block *nb = split_block(b, K / 2);
+            if (index > K / 2) {
+                b = nb;
+                index -= K / 2;
+            }
+            return emplace_in_block(b, index, std::move(value));
+        }
+
+        T *d = b->data();
+        if (index == b->count) {
+            construct_value(d + index, std::forward<Args>(args)...);
+            ++b->count;
+            ++size_;
+        }
+        else {
+            // значение создается до сдвига: аргументы могут ссылаться на значения этого блока
+            T value = make_value(std::forward<Args>(args)...);
+            construct_value(d + b->count, std::move(d[b->count - 1]));
+            ++b->count;
+            ++size_;
+            std::move_backward(d + index, d + b->count - 2, d + b->count - 1);
+            d[index] = std::move(value);
+        }
+        return {b, index};
+    }
+
+    template <class T, class Alloc, size_t K>
+    std::pair<typename unrolled_list<T, Alloc, K>::BaseNode*, size_t>
+    unrolled_list<T, Alloc, K>::erase_in_block(Block* b, size_t index)
+    {
+        T *d = b->data();
+        std::move(d + index + 1, d + b->count, d + index);
+        destroy_value(d + b->count - 1);
+        --b->count;
+        --size_;
+
+        if (b->count == 0) {
+            BaseNode *next = b->next;
+            destroy_block(b);
+            return {next, 0};
+        }
+        try_merge_next(b);
+        if (index < b->count) {
+            return {b, index};
+        }
+        return {b->next, 0};
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::move_to(buffer_type& buffer)
+    {
+        for (iterator it = begin(); it != end(); ++it) {
+            buffer.push_back(std::move(*it));
+        }
+    }
+
+    // конструкторы
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::unrolled_list() noexcept(noexcept(Alloc())) : allocator(), head(), size_(0)
+    {
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::unrolled_list(const Alloc& alloc) noexcept : allocator(alloc), head(), size_(0)
+    {
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::unrolled_list(size_t count, const T& value, const Alloc& alloc)
+        : unrolled_list<T, Alloc, K>(alloc)
+    {
+        while (size_ < count) {
+            push_back(value);
+        }
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::unrolled_list(size_t count, const Alloc& alloc) : unrolled_list<T, Alloc, K>(alloc)
+    {
+        resize(count);
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::~unrolled_list()
+    {
+        clear();
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::unrolled_list(const unrolled_list& other)
+        : unrolled_list<T, Alloc, K>(std::allocator_traits<Alloc>::select_on_container_copy_construction(other.get_allocator()))
+    {
+        for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
+            push_back(*it);
+        }
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>::unrolled_list(unrolled_list&& other) noexcept
+        : allocator(std::move(other.allocator)), head(), size_(0)
+    {
+        swap_blocks(other);
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>& unrolled_list<T, Alloc, K>::operator=(const unrolled_list& other)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        // блоки освобождаются тем аллокатором, которым были выделены, поэтому очистка - до замены аллокатора
+        clear();
+        if constexpr (block_traits::propagate_on_container_copy_assignment::value) {
+            allocator = other.allocator;
+        }
+        for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
+            push_back(*it);
+        }
+        return *this;
+    }
+
+    template <class T, class Alloc, size_t K>
+    unrolled_list<T, Alloc, K>& unrolled_list<T, Alloc, K>::operator=(unrolled_list&& other)
+        noexcept(std::allocator_traits<Alloc>::propagate_on_container_move_assignment::value ||
+                 std::allocator_traits<Alloc>::is_always_equal::value)
+    {
+        if (this == &other) {
+            return *this;
+        }
+        clear();
+        if constexpr (block_traits::propagate_on_container_move_assignment::value) {
+            // свои блоки уже освобождены старым аллокатором, забираем аллокатор и блоки other
+            allocator = std::move(other.allocator);
+            swap_blocks(other);
+        }
+        else if (allocator == other.allocator) {
+            swap_blocks(other);
+        }
+        else {
+            // блоки other нельзя освободить нашим аллокатором: перемещаем значения по одному
+            for (iterator it = other.begin(); it != other.end(); ++it) {
+                push_back(std::move(*it));
+            }
+        }
+        return *this;
+    }
+
+    template <class T, class Alloc, size_t K>
+    Alloc unrolled_list<T, Alloc, K>::get_allocator() const
+    {
+        return Alloc(allocator);
+    }
+
+    // доступ к элементам
+
+    template <class T, class Alloc, size_t K>
+    T& unrolled_list<T, Alloc, K>::front()
+    {
+        return block(head.next)->data()[0];
+    }
+
+    template <class T, class Alloc, size_t K>
+    const T& unrolled_list<T, Alloc, K>::front() const
+    {
+        return block(head.next)->data()[0];
+    }
+
+    template <class T, class Alloc, size_t K>
+    T& unrolled_list<T, Alloc, K>::back()
+    {
+        return block(head.prev)->data()[block(head.prev)->count - 1];
+    }
+
+    template <class T, class Alloc, size_t K>
+    const T& unrolled_list<T, Alloc, K>::back() const
+    {
+        return block(head.prev)->data()[block(head.prev)->count - 1];
+    }
+
+    // получение итераторов
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::begin()
+    {
+        return iterator(head.next, 0);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::end()
+    {
+        return iterator(&head, 0);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::const_iterator unrolled_list<T, Alloc, K>::cbegin() const
+    {
+        return const_iterator(head.next, 0);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::const_iterator unrolled_list<T, Alloc, K>::cend() const
+    {
+        return const_iterator(&head, 0);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::reverse_iterator unrolled_list<T, Alloc, K>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::reverse_iterator unrolled_list<T, Alloc, K>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::const_reverse_iterator unrolled_list<T, Alloc, K>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::const_reverse_iterator unrolled_list<T, Alloc, K>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // размер контейнера
+
+    template <class T, class Alloc, size_t K>
+    bool unrolled_list<T, Alloc, K>::empty() const
+    {
+        return size_ == 0;
+    }
+
+    template <class T, class Alloc, size_t K>
+    size_t unrolled_list<T, Alloc, K>::size() const
+    {
+        return size_;
+    }
+
+    template <class T, class Alloc, size_t K>
+    size_t unrolled_list<T, Alloc, K>::max_size() const
+    {
+        return block_traits::max_size(allocator);
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::clear()
+    {
+        while (head.next != &head) {
+            destroy_block(block(head.next));
+        }
+    }
+
+    // добавление элементов
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::emplace(const_iterator pos, Args&&... args)
+    {
+        BaseNode *node = const_cast<BaseNode*>(pos.node);
+        size_t index = pos.index;
+        if (node == &head || (index == 0 && node->prev != &head && block(node->prev)->count < K)) {
+            // перед началом блока (или в конец списка) дописываем в конец предыдущего блока, без сдвига
+            node = node->prev;
+            if (node == &head) { // пустой список: первый блок создается вместе со значением
+                return iterator(create_block(&head, &head, std::forward<Args>(args)...), 0);
+            }
+            index = block(node)->count;
+        }
+        std::pair<Block*, size_t> place = emplace_in_block(block(node), index, std::forward<Args>(args)...);
+        return iterator(place.first, place.second);
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    void unrolled_list<T, Alloc, K>::emplace_back(Args&&... args)
+    {
+        emplace(cend(), std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class... Args>
+    void unrolled_list<T, Alloc, K>::emplace_front(Args&&... args)
+    {
+        emplace(cbegin(), std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::insert(const_iterator pos, size_t count, const T& value)
+    {
+        // вставка каждый раз перед только что вставленным значением: возвращаемый итератор
+        // всегда действителен и в конце указывает на первое из вставленных.
+        // value может быть ссылкой на значение списка, которое сдвинется или уничтожится
+        // при делении блока: вставляем копии с копии
+        if (count == 0) {
+            return iterator(const_cast<BaseNode*>(pos.node), pos.index);
+        }
+        const T copy = make_value(value);
+        iterator it(const_cast<BaseNode*>(pos.node), pos.index);
+        for (size_t i = 0; i < count; ++i) {
+            it = emplace(it, copy);
+        }
+        return it;
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::push_back(const T& value)
+    {
+        emplace(cend(), value);
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::push_back(T&& value)
+    {
+        emplace(cend(), std::move(value));
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::push_front(const T& value)
+    {
+        emplace(cbegin(), value);
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::push_front(T&& value)
+    {
+        emplace(cbegin(), std::move(value));
+    }
+
+    // удаление элементов
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::erase(const_iterator pos)
+    {
+        std::pair<BaseNode*, size_t> next = erase_in_block(block(const_cast<BaseNode*>(pos.node)), pos.index);
+        return iterator(next.first, next.second);
+    }
+
+    template <class T, class Alloc, size_t K>
+    typename unrolled_list<T, Alloc, K>::iterator unrolled_list<T, Alloc, K>::erase(const_iterator first, const_iterator last)
+    {
+        if (first == last) {
+            return iterator(const_cast<BaseNode*>(last.node), last.index);
+        }
+        Block *fb = block(const_cast<BaseNode*>(first.node));
+        BaseNode *lb = const_cast<BaseNode*>(last.node);
+
+        if (fb == lb) {
+            // диапазон внутри одного блока: сдвигаем хвост блока на место удаленных
+            T *d = fb->data();
+            size_t removed = last.index - first.index;
+            std::move(d + last.index, d + fb->count, d + first.index);
+            for (size_t i = fb->count - removed; i < fb->count; ++i) {
+                destroy_value(d + i);
+            }
+            fb->count -= removed;
+            size_ -= removed;
+            try_merge_next(fb);
+            if (first.index < fb->count) {
+                return iterator(fb, first.index);
+            }
+            return iterator(fb->next, 0);
+        }
+
+        // хвост первого блока
+        T *d = fb->data();
+        for (size_t i = first.index; i < fb->count; ++i) {
+            destroy_value(d + i);
+        }
+        size_ -= fb->count - first.index;
+        fb->count = first.index;
+        // целые блоки между первым и последним
+        while (fb->next != lb) {
+            destroy_block(block(fb->next));
+        }
+        // начало последнего блока
+        if (lb != &head && last.index > 0) {
+            Block *b = block(lb);
+            T *ld = b->data();
+            std::move(ld + last.index, ld + b->count, ld);
+            for (size_t i = b->count - last.index; i < b->count; ++i) {
+                destroy_value(ld + i);
+            }
+            b->count -= last.index;
+            size_ -= last.index;
+        }
+
+        if (fb->count == 0) {
+            destroy_block(fb);
+            return iterator(lb, 0);
+        }
+        if (try_merge_next(fb)) {
+            return iterator(fb, first.index);
+        }
+        return iterator(lb, 0);
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::pop_back()
+    {
+        if (!empty()) {
+            erase_in_block(block(head.prev), block(head.prev)->count - 1);
+        }
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::pop_front()
+    {
+        if (!empty()) {
+            erase_in_block(block(head.next), 0);
+        }
+    }
+
+    // изменение размера списка
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::resize(size_t count)
+    {
+        while (size_ < count) {
+            emplace_back();
+        }
+        if (size_ > count) {
+            const_iterator from = cend();
+            for (size_t i = count; i < size_; ++i) {
+                --from;
+            }
+            erase(from, cend());
+        }
+    }
+
+    // обмен списков местами
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::swap(unrolled_list& other)
+    {
+        swap_blocks(other);
+        if constexpr (block_traits::propagate_on_container_swap::value) {
+            using std::swap;
+            swap(allocator, other.allocator);
+        }
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::swap_blocks(unrolled_list& other) noexcept
+    {
+        // блоки ссылаются на границу списка, поэтому обмениваем цепочки через временную границу
+        BaseNode tmp;
+        auto take = [](BaseNode& to, BaseNode& from) {
+            if (from.next != &from) {
+                to.next = from.next;
+                to.prev = from.prev;
+                to.next->prev = &to;
+                to.prev->next = &to;
+                from.next = from.prev = &from;
+            }
+        };
+        take(tmp, head);
+        take(head, other.head);
+        take(other.head, tmp);
+        std::swap(size_, other.size_);
+    }
+
+    // слияние, перемещение и удаление
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::merge(unrolled_list& other)
+    {
+        merge(other, std::less<T>());
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class Compare>
+    void unrolled_list<T, Alloc, K>::merge(unrolled_list& other, Compare comp)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        // значения сливаются в буфере и укладываются обратно в полностью заполненные блоки
+        buffer_type buffer(allocator);
+        buffer.reserve(size_ + other.size_);
+        move_to(buffer);
+        size_t middle = buffer.size();
+        other.move_to(buffer);
+        std::inplace_merge(buffer.begin(), buffer.begin() + middle, buffer.end(), comp);
+        clear();
+        other.clear();
+        for (T& value : buffer) {
+            emplace_back(std::move(value));
+        }
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::splice(const_iterator pos, unrolled_list& other)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        // блоки other вставляются целиком; если pos в середине блока, блок сначала делится
+        BaseNode *next = const_cast<BaseNode*>(pos.node);
+        if (next != &head && pos.index > 0) {
+            next = split_block(block(next), pos.index);
+        }
+        BaseNode *prev = next->prev;
+        prev->next = other.head.next;
+        other.head.next->prev = prev;
+        next->prev = other.head.prev;
+        other.head.prev->next = next;
+        other.head.next = other.head.prev = &other.head;
+        size_ += other.size_;
+        other.size_ = 0;
+    }
+
+    template <class T, class Alloc, size_t K>
+    size_t unrolled_list<T, Alloc, K>::remove(const T& value)
+    {
+        // value может ссылаться на значение списка, которое будет перезаписано при сдвиге
+        const T target = value;
+        return remove_if([&target](const T& element) { return element == target; });
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class UnaryPredicate>
+    size_t unrolled_list<T, Alloc, K>::remove_if(UnaryPredicate pred)
+    {
+        // оставшиеся значения сдвигаются к началу за один проход, хвост удаляется целиком
+        iterator new_end = std::remove_if(begin(), end(), pred);
+        size_t count = std::distance(new_end, end());
+        erase(new_end, end());
+        return count;
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::reverse()
+    {
+        // меняем порядок блоков и порядок значений внутри каждого блока
+        BaseNode *node = &head;
+        do {
+            std::swap(node->next, node->prev);
+            node = node->prev;
+            if (node != &head) {
+                std::reverse(block(node)->data(), block(node)->data() + block(node)->count);
+            }
+        } while (node != &head);
+    }
+
+    template <class T, class Alloc, size_t K>
+    size_t unrolled_list<T, Alloc, K>::unique()
+    {
+        return unique(std::equal_to<T>());
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class BinaryPredicate>
+    size_t unrolled_list<T, Alloc, K>::unique(BinaryPredicate pred)
+    {
+        iterator new_end = std::unique(begin(), end(), pred);
+        size_t count = std::distance(new_end, end());
+        erase(new_end, end());
+        return count;
+    }
+
+    template <class T, class Alloc, size_t K>
+    void unrolled_list<T, Alloc, K>::sort()
+    {
+        sort(std::less<T>());
+    }
+
+    template <class T, class Alloc, size_t K>
+    template <class Compare>
+    void unrolled_list<T, Alloc, K>::sort(Compare comp)
+    {
+        if (size_ < 2) {
+            return;
+        }
+        // значения сортируются в непрерывном буфере и возвращаются на свои места в блоках
+        buffer_type buffer(allocator);
+        buffer.reserve(size_);
+        move_to(buffer);
+        std::stable_sort(buffer.begin(), buffer.end(), comp);
+        std::move(buffer.begin(), buffer.end(), begin());
+    }
+
+}  // namespace task
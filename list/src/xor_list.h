@@ -0,0 +1,599 @@
+#pragma once
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory> // для allocator_traits
+#include <utility>
+
+namespace task {
+
+// двусвязный список, в котором узел хранит одно слово prev ^ next вместо двух указателей.
+// Соседа можно получить, только зная другого соседа, поэтому итератор хранит пару
+// (предыдущий, текущий) узлов. Крайние узлы ссылаются на nullptr, границы списка - указатели
+// head и tail, поэтому reverse и splice целого списка выполняются за O(1).
+// insert и erase делают недействительными итераторы на соседние с позицией узлы (в их паре
+// меняется предыдущий узел), reverse и splice - итераторы end() и на крайние элементы.
+// end() - это пара (tail, nullptr), а begin() - (nullptr, head), поэтому сохраненный end()
+// становится недействительным после push_back, emplace_back, pop_back и insert/erase в конце
+// списка, а сохраненный begin() - после таких же операций в начале
+template<class T, class Alloc = std::allocator<T>>
+class xor_list {
+private:
+    class Node {
+    public:
+        std::uintptr_t link; // адрес предыдущего узла ^ адрес следующего
+        T data;
+        template <class... Args>
+        Node(std::uintptr_t l, Args&&... args) : link(l), data(std::forward<Args>(args)...) {};
+    };
+    // аллокатор для типа Node
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Node>;
+    using node_traits = std::allocator_traits<allocator_type>;
+    allocator_type allocator;
+    Node *head; // первый узел
+    Node *tail; // последний узел
+    size_t size_;
+
+    static std::uintptr_t address(const Node* node) { return reinterpret_cast<std::uintptr_t>(node); }
+    // сосед node, противоположный other
+    static Node* neighbour(const Node* node, const Node* other) {
+        return reinterpret_cast<Node*>(node->link ^ address(other));
+    }
+    // замена соседа from узла node на to
+    static void relink(Node* node, const Node* from, const Node* to) {
+        if (node != nullptr) {
+            node->link ^= address(from) ^ address(to);
+        }
+    }
+
+    // вставка нового узла между соседними prev и next
+    template <class... Args>
+    Node* emplace_between(Node* prev, Node* next, Args&&... args);
+    // удаление узла node с соседями prev и next
+    void destroy_between(Node* prev, Node* node, Node* next) noexcept;
+
+public:
+    class const_iterator;
+
+    class iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = T*;
+        using reference = T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        iterator() : prev(nullptr), cur(nullptr) {}
+
+        iterator& operator++() {
+            Node *next = neighbour(cur, prev);
+            prev = cur;
+            cur = next;
+            return *this;
+        }
+        iterator operator++(int) {
+            iterator it = *this;
+            ++*this;
+            return it;
+        }
+        reference operator*() const { return cur->data; }
+        pointer operator->() const { return &cur->data; }
+        iterator& operator--() {
+            Node *before = neighbour(prev, cur);
+            cur = prev;
+            prev = before;
+            return *this;
+        }
+        iterator operator--(int) {
+            iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(iterator other) const { return cur == other.cur && prev == other.prev; }
+        bool operator!=(iterator other) const { return !(*this == other); }
+
+        friend class xor_list;
+        friend class const_iterator;
+    private:
+        iterator(Node* p, Node* c) : prev(p), cur(c) {}
+        Node *prev; // узел перед текущим (nullptr у begin())
+        Node *cur; // текущий узел (nullptr у end())
+    };
+
+    class const_iterator {
+    public:
+        using difference_type = ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+        using iterator_category = std::bidirectional_iterator_tag;
+
+        const_iterator() : prev(nullptr), cur(nullptr) {}
+        const_iterator(const iterator& other) : prev(other.prev), cur(other.cur) {}
+
+        const_iterator& operator++() {
+            Node *next = neighbour(cur, prev);
+            prev = cur;
+            cur = next;
+            return *this;
+        }
+        const_iterator operator++(int) {
+            const_iterator it = *this;
+            ++*this;
+            return it;
+        }
+        reference operator*() const { return cur->data; }
+        pointer operator->() const { return &cur->data; }
+        const_iterator& operator--() {
+            Node *before = neighbour(prev, cur);
+            cur = prev;
+            prev = before;
+            return *this;
+        }
+        const_iterator operator--(int) {
+            const_iterator it = *this;
+            --*this;
+            return it;
+        }
+
+        bool operator==(const_iterator other) const { return cur == other.cur && prev == other.prev; }
+        bool operator!=(const_iterator other) const { return !(*this == other); }
+
+        friend class xor_list;
+    private:
+        const_iterator(Node* p, Node* c) : prev(p), cur(c) {}
+        Node *prev;
+        Node *cur;
+    };
+
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+
+    xor_list() noexcept(noexcept(Alloc()));
+    explicit xor_list(const Alloc& alloc) noexcept;
+    xor_list(size_t count, const T& value, const Alloc& alloc = Alloc());
+    xor_list(std::initializer_list<T> init, const Alloc& alloc = Alloc());
+
+    ~xor_list();
+
+    xor_list(const xor_list& other);
+    xor_list(xor_list&& other) noexcept;
+    xor_list& operator=(const xor_list& other);
+    xor_list& operator=(xor_list&& other);
+
+    Alloc get_allocator() const;
+
+
+    T& front();
+    const T& front() const;
+
+    T& back();
+    const T& back() const;
+
+
+    iterator begin();
+    iterator end();
+
+    const_iterator cbegin() const;
+    const_iterator cend() const;
+
+    reverse_iterator rbegin();
+    reverse_iterator rend();
+
+    const_reverse_iterator crbegin() const;
+    const_reverse_iterator crend() const;
+
+
+    bool empty() const;
+    size_t size() const;
+    size_t max_size() const;
+    void clear();
+
+    iterator insert(const_iterator pos, const T& value);
+    iterator insert(const_iterator pos, T&& value);
+    iterator erase(const_iterator pos);
+
+    void push_back(const T& value);
+    void push_back(T&& value);
+    void pop_back();
+
+    void push_front(const T& value);
+    void push_front(T&& value);
+    void pop_front();
+
+    template <class... Args>
+    iterator emplace(const_iterator pos, Args&&... args);
+
+    template <class... Args>
+    void emplace_back(Args&&... args);
+
+    template <class... Args>
+    void emplace_front(Args&&... args);
+
+    void swap(xor_list& other) noexcept;
+
+    // перемещение всех узлов other перед pos за O(1)
+    void splice(const_iterator pos, xor_list& other);
+    // разворот за O(1): меняются местами head и tail
+    void reverse() noexcept;
+};
+
+    // работа с узлами
+
+    template <class T, class Alloc>
+    template <class... Args>
+    typename xor_list<T, Alloc>::Node* xor_list<T, Alloc>::emplace_between(Node* prev, Node* next, Args&&... args)
+    {
+        Node *node = node_traits::allocate(allocator, 1);
+        try {
+            node_traits::construct(allocator, node, address(prev) ^ address(next), std::forward<Args>(args)...);
+        }
+        catch (...) {
+            node_traits::deallocate(allocator, node, 1);
+            throw;
+        }
+        relink(prev, next, node);
+        relink(next, prev, node);
+        if (prev == nullptr) {
+            head = node;
+        }
+        if (next == nullptr) {
+            tail = node;
+        }
+        ++size_;
+        return node;
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::destroy_between(Node* prev, Node* node, Node* next) noexcept
+    {
+        relink(prev, node, next);
+        relink(next, node, prev);
+        if (prev == nullptr) {
+            head = next;
+        }
+        if (next == nullptr) {
+            tail = prev;
+        }
+        node_traits::destroy(allocator, node);
+        node_traits::deallocate(allocator, node, 1);
+        --size_;
+    }
+
+    // конструкторы
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::xor_list() noexcept(noexcept(Alloc()))
+        : allocator(), head(nullptr), tail(nullptr), size_(0)
+    {
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::xor_list(const Alloc& alloc) noexcept
+        : allocator(alloc), head(nullptr), tail(nullptr), size_(0)
+    {
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::xor_list(size_t count, const T& value, const Alloc& alloc) : xor_list<T, Alloc>(alloc)
+    {
+        try {
+            for (; count > 0; --count) {
+                push_back(value);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::xor_list(std::initializer_list<T> init, const Alloc& alloc) : xor_list<T, Alloc>(alloc)
+    {
+        try {
+            for (const T& value : init) {
+                push_back(value);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::~xor_list()
+    {
+        clear();
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::xor_list(const xor_list& other)
+        : xor_list<T, Alloc>(node_traits::select_on_container_copy_construction(other.allocator))
+    {
+        try {
+            for (const_iterator it = other.cbegin(); it != other.cend(); ++it) {
+                push_back(*it);
+            }
+        }
+        catch (...) {
+            clear();
+            throw;
+        }
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>::xor_list(xor_list&& other) noexcept
+        : allocator(std::move(other.allocator)), head(other.head), tail(other.tail), size_(other.size_)
+    {
+        other.head = other.tail = nullptr;
+        other.size_ = 0;
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>& xor_list<T, Alloc>::operator=(const xor_list& other)
+    {
+        if (this != &other) {
+            xor_list copy(other);
+            swap(copy);
+        }
+        return *this;
+    }
+
+    template <class T, class Alloc>
+    xor_list<T, Alloc>& xor_list<T, Alloc>::operator=(xor_list&& other)
+    {
+        if (this != &other) {
+            clear();
+            swap(other);
+        }
+        return *this;
+    }
+
+    template <class T, class Alloc>
+    Alloc xor_list<T, Alloc>::get_allocator() const
+    {
+        return Alloc(allocator);
+    }
+
+    // доступ к элементам
+
+    template <class T, class Alloc>
+    T& xor_list<T, Alloc>::front()
+    {
+        return head->data;
+    }
+
+    template <class T, class Alloc>
+    const T& xor_list<T, Alloc>::front() const
+    {
+        return head->data;
+    }
+
+    template <class T, class Alloc>
+    T& xor_list<T, Alloc>::back()
+    {
+        return tail->data;
+    }
+
+    template <class T, class Alloc>
+    const T& xor_list<T, Alloc>::back() const
+    {
+        return tail->data;
+    }
+
+    // получение итераторов
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::iterator xor_list<T, Alloc>::begin()
+    {
+        return iterator(nullptr, head);
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::iterator xor_list<T, Alloc>::end()
+    {
+        return iterator(tail, nullptr);
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::const_iterator xor_list<T, Alloc>::cbegin() const
+    {
+        return const_iterator(nullptr, head);
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::const_iterator xor_list<T, Alloc>::cend() const
+    {
+        return const_iterator(tail, nullptr);
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::reverse_iterator xor_list<T, Alloc>::rbegin()
+    {
+        return reverse_iterator(end());
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::reverse_iterator xor_list<T, Alloc>::rend()
+    {
+        return reverse_iterator(begin());
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::const_reverse_iterator xor_list<T, Alloc>::crbegin() const
+    {
+        return const_reverse_iterator(cend());
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::const_reverse_iterator xor_list<T, Alloc>::crend() const
+    {
+        return const_reverse_iterator(cbegin());
+    }
+
+    // размер контейнера
+
+    template <class T, class Alloc>
+    bool xor_list<T, Alloc>::empty() const
+    {
+        return size_ == 0;
+    }
+
+    template <class T, class Alloc>
+    size_t xor_list<T, Alloc>::size() const
+    {
+        return size_;
+    }
+
+    template <class T, class Alloc>
+    size_t xor_list<T, Alloc>::max_size() const
+    {
+        return node_traits::max_size(allocator);
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::clear()
+    {
+        Node *prev = nullptr, *node = head;
+        while (node != nullptr) {
+            Node *next = neighbour(node, prev);
+            node_traits::destroy(allocator, node);
+            node_traits::deallocate(allocator, node, 1);
+            prev = node;
+            node = next;
+        }
+        head = tail = nullptr;
+        size_ = 0;
+    }
+
+    // добавление элементов
+
+    template <class T, class Alloc>
+    template <class... Args>
+    typename xor_list<T, Alloc>::iterator xor_list<T, Alloc>::emplace(const_iterator pos, Args&&... args)
+    {
+        return iterator(pos.prev, emplace_between(pos.prev, pos.cur, std::forward<Args>(args)...));
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void xor_list<T, Alloc>::emplace_back(Args&&... args)
+    {
+        emplace_between(tail, nullptr, std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc>
+    template <class... Args>
+    void xor_list<T, Alloc>::emplace_front(Args&&... args)
+    {
+        emplace_between(nullptr, head, std::forward<Args>(args)...);
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::iterator xor_list<T, Alloc>::insert(const_iterator pos, const T& value)
+    {
+        return emplace(pos, value);
+    }
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::iterator xor_list<T, Alloc>::insert(const_iterator pos, T&& value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::push_back(const T& value)
+    {
+        emplace_back(value);
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::push_back(T&& value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::push_front(const T& value)
+    {
+        emplace_front(value);
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::push_front(T&& value)
+    {
+        emplace_front(std::move(value));
+    }
+
+    // удаление элементов
+
+    template <class T, class Alloc>
+    typename xor_list<T, Alloc>::iterator xor_list<T, Alloc>::erase(const_iterator pos)
+    {
+        Node *next = neighbour(pos.cur, pos.prev);
+        destroy_between(pos.prev, pos.cur, next);
+        return iterator(pos.prev, next);
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::pop_back()
+    {
+        if (!empty()) {
+            destroy_between(neighbour(tail, nullptr), tail, nullptr);
+        }
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::pop_front()
+    {
+        if (!empty()) {
+            destroy_between(nullptr, head, neighbour(head, nullptr));
+        }
+    }
+
+    // обмен списков местами: узлы не ссылаются на сам список, достаточно обменять указатели
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::swap(xor_list& other) noexcept
+    {
+        std::swap(head, other.head);
+        std::swap(tail, other.tail);
+        std::swap(size_, other.size_);
+        if (node_traits::propagate_on_container_swap::value) {
+            std::swap(allocator, other.allocator);
+        }
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::splice(const_iterator pos, xor_list& other)
+    {
+        if (this == &other || other.empty()) {
+            return;
+        }
+        // цепочка other встает между pos.prev и pos.cur: меняются только четыре крайних узла
+        relink(pos.prev, pos.cur, other.head);
+        relink(other.head, nullptr, pos.prev);
+        relink(other.tail, nullptr, pos.cur);
+        relink(pos.cur, pos.prev, other.tail);
+        if (pos.prev == nullptr) {
+            head = other.head;
+        }
+        if (pos.cur == nullptr) {
+            tail = other.tail;
+        }
+        size_ += other.size_;
+        other.head = other.tail = nullptr;
+        other.size_ = 0;
+    }
+
+    template <class T, class Alloc>
+    void xor_list<T, Alloc>::reverse() noexcept
+    {
+        // prev ^ next симметрично, поэтому обход с другого конца уже дает обратный порядок
+        std::swap(head, tail);
+    }
+
+}  // namespace task
@@ -1,10 +1,27 @@
+#include <cmath>
+#include <cstddef>
+#include <functional>
 #include <iostream>
 #include <string>
 #include <random>
 #include <algorithm>
+#include <atomic>
 #include <vector>
 #include <list>
+#include <forward_list>
+#include <memory_resource>
+#include <stdexcept>
+#include <thread>
 #include "src/list.h"
+#include "src/unrolled_list.h"
+#include "src/intrusive_list.h"
+#include "src/xor_list.h"
+#include "src/lru_cache.h"
+#include "src/mpsc_list_queue.h"
+#include "src/persistent_list.h"
+#include "src/counting_allocator.h"
+#include "src/forward_list.h"
+#include "src/small_list.h"
 
 
 size_t RandomUInt(size_t max = -1) {
@@ -53,6 +70,36 @@ struct MoveTester {
     MoveTester& operator=(MoveTester&&) noexcept { action = "MA"; return *this; }
 };
 
+struct CopyThrower {
+    static int copies_left;    // copy constructor throws when it reaches zero
+    size_t value;
+
+    CopyThrower(size_t v) : value(v) {}
+    CopyThrower(const CopyThrower& other) : value(other.value) {
+        if (copies_left-- == 0) {
+            throw std::runtime_error("copy");
+        }
+    }
+    // assignment never throws: only constructing new values can fail
+    CopyThrower& operator=(const CopyThrower& other) noexcept {
+        value = other.value;
+        return *this;
+    }
+
+    bool operator==(const CopyThrower& other) const { return value == other.value; }
+};
+
+int CopyThrower::copies_left = -1;
+
+struct Timer : task::list_hook {
+    size_t deadline;
+    task::auto_unlink_list_hook by_owner; // второй список, в котором таймер может находиться
+
+    explicit Timer(size_t d = 0) : deadline(d) {}
+    bool operator<(const Timer& other) const { return deadline < other.deadline; }
+    bool operator==(const Timer& other) const { return deadline == other.deadline; }
+};
+
 struct ArgForwardTester {
     std::string actions;
 
@@ -78,6 +125,96 @@ void FailWithMsg(const std::string& msg, int line) {
     ASSERT_TRUE_MSG(std::equal(cont1.begin(), cont1.end(), cont2.begin(), cont2.end()), msg)
 
 
+// allocator that frees erased elements in batches through the deallocate_chain hook
+size_t chain_calls = 0;
+
+template <class T>
+struct ChainAllocator : std::allocator<T> {
+    template <class U>
+    struct rebind { using other = ChainAllocator<U>; };
+
+    ChainAllocator() = default;
+    template <class U>
+    ChainAllocator(const ChainAllocator<U>&) {}
+
+    void deallocate_chain(T* first, size_t count) {
+        ++chain_calls;
+        for (; first != nullptr; --count) {
+            T* next = *reinterpret_cast<T**>(first);
+            std::allocator<T>::deallocate(first, 1);
+            first = next;
+        }
+        ASSERT_TRUE_MSG(count == 0, "deallocate_chain: count matches chain length")
+    }
+};
+
+
+// calls made to a counting_allocator while f runs
+struct AllocatorCalls {
+    size_t allocations, deallocations, constructions, destructions;
+};
+
+template <class F>
+AllocatorCalls CountCalls(const task::allocation_stats& stats, F&& f) {
+    task::allocation_stats before = stats;
+    f();
+    return {stats.allocations - before.allocations, stats.deallocations - before.deallocations,
+            stats.constructions - before.constructions, stats.destructions - before.destructions};
+}
+
+
+// stateful allocator: memory is tagged with the allocator id, freeing it through
+// an allocator with another id is recorded as an error
+size_t tag_mismatches = 0;
+// аллокатор, который уже заменен и не должен больше выделять память
+int retired_tag = -2;
+
+template <class T, bool Propagate>
+struct TaggedAllocator {
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_move_assignment = std::integral_constant<bool, Propagate>;
+    using propagate_on_container_swap = std::integral_constant<bool, Propagate>;
+    template <class U>
+    struct rebind { using other = TaggedAllocator<U, Propagate>; };
+
+    int id;
+
+    explicit TaggedAllocator(int id = 0) : id(id) {}
+    template <class U>
+    TaggedAllocator(const TaggedAllocator<U, Propagate>& other) : id(other.id) {}
+
+    T* allocate(size_t n) {
+        if (id == retired_tag) {
+            ++tag_mismatches;
+        }
+        int* block = static_cast<int*>(::operator new(n * sizeof(T) + alignof(std::max_align_t)));
+        *block = id;
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(block) + alignof(std::max_align_t));
+    }
+    void deallocate(T* p, size_t) {
+        int* block = reinterpret_cast<int*>(reinterpret_cast<char*>(p) - alignof(std::max_align_t));
+        if (*block != id) {
+            ++tag_mismatches;
+        }
+        ::operator delete(block);
+    }
+    TaggedAllocator select_on_container_copy_construction() const {
+        return TaggedAllocator(Propagate ? id : -1);
+    }
+};
+
+template <class T, class U, bool Propagate>
+bool operator==(const TaggedAllocator<T, Propagate>& a, const TaggedAllocator<U, Propagate>& b) {
+    return a.id == b.id;
+}
+
+template <class T, class U, bool Propagate>
+bool operator!=(const TaggedAllocator<T, Propagate>& a, const TaggedAllocator<U, Propagate>& b) {
+    return a.id != b.id;
+}
+
+
 int main() {
 
     {
@@ -119,6 +256,27 @@ int main() {
         list = std::move(list2);
         list2 = task::list<Immovable>(10);
         list.swap(list2);
+
+        list.emplace_back();
+        list.emplace_front();
+        auto it = list.emplace(std::next(list.begin()));
+        ASSERT_TRUE(list.size() == 13 && it == std::next(list.begin()))
+    }
+
+
+    {
+        static_assert(std::is_nothrow_default_constructible<task::list<MoveTester>>::value, "noexcept list()");
+        static_assert(std::is_nothrow_move_constructible<task::list<MoveTester>>::value, "noexcept list(list&&)");
+
+        task::list<std::string> list;
+        task::list<std::string> list2 = std::move(list);
+        list2.push_back("test");
+        list = std::move(list2);
+        ASSERT_TRUE(list.size() == 1 && list2.empty())
+        list2.push_back("test2");
+        list.swap(list2);
+        list.reverse();
+        ASSERT_TRUE(list.front() == "test2" && list2.back() == "test")
     }
 
 
@@ -142,6 +300,22 @@ int main() {
     }
 
 
+    {
+        task::list<MoveTester> list(3);
+        task::list<MoveTester> list2(5);
+        auto& element_reference = list.front();
+        list = list2;
+        ASSERT_TRUE_MSG(&element_reference == &list.front(), "copy assignment reuses nodes")
+        ASSERT_TRUE_MSG(list.front().action == "CA" && list.back().action == "CC", "copy assignment")
+
+        list2.resize(2);
+        list = list2;
+        ASSERT_TRUE_MSG(list.size() == 2 && list.back().action == "CA", "copy assignment to a longer list")
+        list = list;
+        ASSERT_TRUE_MSG(list.size() == 2, "self copy assignment")
+    }
+
+
     {
         task::list<size_t> list_task(10, 30);
         std::list<size_t> list_std(10, 30);
@@ -165,6 +339,56 @@ int main() {
     }
 
 
+    {
+        std::vector<size_t> values = {1, 2, 3, 4, 5};
+        task::list<size_t> list_task(3, 7);
+        std::list<size_t> list_std(3, 7);
+
+        auto it_task = list_task.insert(std::next(list_task.cbegin()), values.begin(), values.end());
+        auto it_std = list_std.insert(std::next(list_std.cbegin()), values.begin(), values.end());
+        ASSERT_TRUE_MSG(*it_task == *it_std, "list::insert(pos, first, last) result")
+
+        list_task.insert(list_task.cend(), {8, 9});
+        list_std.insert(list_std.cend(), {8, 9});
+        it_task = list_task.insert(list_task.cbegin(), values.end(), values.end());
+        ASSERT_TRUE_MSG(it_task == list_task.begin(), "list::insert of empty range")
+
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::insert(pos, first, last)")
+
+        task::list<CopyThrower> list_throw(3, CopyThrower(1));
+        std::vector<CopyThrower> source(10, CopyThrower(2));
+        CopyThrower::copies_left = 5;
+        try {
+            list_throw.insert(std::next(list_throw.cbegin()), source.begin(), source.end());
+            ASSERT_TRUE_MSG(false, "exception expected")
+        } catch (const std::runtime_error&) {
+        }
+        CopyThrower::copies_left = -1;
+        ASSERT_TRUE_MSG(list_throw.size() == 3 && std::count(list_throw.begin(), list_throw.end(), CopyThrower(1)) == 3,
+                        "list::insert strong exception guarantee")
+    }
+
+
+    {
+        task::list<std::string, ChainAllocator<std::string>> list_task(100, "test");
+        std::list<std::string> list_std(100, "test");
+
+        list_task.erase(std::next(list_task.begin(), 10), std::prev(list_task.end(), 10));
+        list_std.erase(std::next(list_std.begin(), 10), std::prev(list_std.end(), 10));
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::erase(first, last)")
+
+        list_task.resize(5);
+        list_std.resize(5);
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::resize")
+
+        list_task.clear();
+        ASSERT_TRUE(list_task.empty() && list_task.begin() == list_task.end())
+        ASSERT_TRUE_MSG(chain_calls == 3, "deallocate_chain called once per batch")
+        list_task.push_back("test");
+        ASSERT_TRUE(list_task.size() == 1)
+    }
+
+
     {
         task::list<size_t> list;
         RandomFill(list, RandomUInt(1000, 5000));
@@ -272,6 +496,1617 @@ int main() {
         }
     }
 
+    {
+        task::list<std::pair<size_t, size_t>> list_task;
+        std::list<std::pair<size_t, size_t>> list_std;
+
+        for (size_t i = RandomUInt(1000, 5000); i > 0; --i) {
+            auto val = std::make_pair(RandomUInt(20), i);
+            list_task.push_back(val);
+            list_std.push_back(val);
+        }
+
+        auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+        list_task.sort(by_key);
+        list_std.sort(by_key);
+
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::sort(Compare) stability")
+
+        list_task.sort(std::greater<>());
+        list_std.sort(std::greater<>());
+
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::sort(Compare)")
+    }
+
+    {
+        auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+        for (int pattern = 0; pattern < 4; ++pattern) {
+            task::list<std::pair<size_t, size_t>> list_task;
+            std::list<std::pair<size_t, size_t>> list_std;
+
+            size_t size = RandomUInt(1000, 5000);
+            for (size_t i = 0; i < size; ++i) {
+                size_t key = RandomUInt(size / 4);
+                if (pattern == 1) {
+                    key = i / 3;             // sorted with equal keys
+                } else if (pattern == 2) {
+                    key = (size - i) / 3;    // reverse sorted with equal keys
+                } else if (pattern == 3) {
+                    key = TossCoin() ? i : RandomUInt(size);    // ascending runs
+                }
+                list_task.emplace_back(key, i);
+                list_std.emplace_back(key, i);
+            }
+
+            list_task.adaptive_sort(by_key);
+            list_std.sort(by_key);
+
+            ASSERT_EQUAL_MSG(list_task, list_std, "list::adaptive_sort stability")
+            ASSERT_TRUE_MSG(std::equal(list_task.crbegin(), list_task.crend(), list_std.crbegin(), list_std.crend()),
+                            "list::adaptive_sort links")
+        }
+    }
+
+    {
+        // исключение из компаратора на любом шаге: все элементы остаются в списке, связи целы
+        for (int pattern = 0; pattern < 3; ++pattern) {
+            std::vector<size_t> values;
+            size_t size = RandomUInt(1000, 3000);
+            for (size_t i = 0; i < size; ++i) {
+                values.push_back(pattern == 0 ? RandomUInt(size) : pattern == 1 ? i / 3 + TossCoin() * 5 : size - i);
+            }
+            std::vector<size_t> sorted = values;
+            std::sort(sorted.begin(), sorted.end());
+
+            size_t comparisons_left = 0;
+            auto throwing_less = [&comparisons_left](size_t a, size_t b) {
+                if (--comparisons_left == 0) {
+                    throw std::runtime_error("compare");
+                }
+                return a < b;
+            };
+            task::list<size_t> list_task;
+            list_task.insert(list_task.cend(), values.begin(), values.end());
+            comparisons_left = size_t(1) << 40;
+            list_task.adaptive_sort(throwing_less);
+            size_t total = (size_t(1) << 40) - comparisons_left;
+
+            bool consistent = true;
+            for (size_t limit = 1; limit <= total; limit += 1 + total / 50) {
+                list_task.clear();
+                list_task.insert(list_task.cend(), values.begin(), values.end());
+                comparisons_left = limit;
+                try {
+                    list_task.adaptive_sort(throwing_less);
+                    consistent = false;
+                }
+                catch (const std::runtime_error&) {
+                }
+                std::vector<size_t> forward(list_task.begin(), list_task.end());
+                std::vector<size_t> backward(list_task.crbegin(), list_task.crend());
+                std::reverse(backward.begin(), backward.end());
+                std::sort(forward.begin(), forward.end());
+                std::sort(backward.begin(), backward.end());
+                consistent = consistent && list_task.size() == size && forward == sorted && backward == sorted;
+            }
+            ASSERT_TRUE_MSG(consistent, "list::adaptive_sort keeps elements on exception")
+        }
+    }
+
+    {
+        task::list<std::pair<size_t, size_t>> list_task;
+        std::list<std::pair<size_t, size_t>> list_std;
+        for (size_t i = RandomUInt(100000, 200000); i > 0; --i) {
+            auto val = std::make_pair(RandomUInt(1000), i);
+            list_task.push_back(val);
+            list_std.push_back(val);
+        }
+
+        auto by_key = [](const auto& a, const auto& b) { return a.first < b.first; };
+        list_task.parallel_sort(by_key, RandomUInt(2, 7));
+        list_std.sort(by_key);
+
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::parallel_sort stability")
+        ASSERT_TRUE_MSG(std::equal(list_task.crbegin(), list_task.crend(), list_std.crbegin(), list_std.crend()),
+                        "list::parallel_sort links")
+    }
+
+    {
+        // исключение из компаратора или функции доходит до вызывающего, элементы остаются в списке
+        task::list<size_t> list_task;
+        RandomFill(list_task, RandomUInt(100000, 150000));
+        std::vector<size_t> sorted(list_task.begin(), list_task.end());
+        std::sort(sorted.begin(), sorted.end());
+        auto same_elements = [&list_task, &sorted]() {
+            std::vector<size_t> values(list_task.begin(), list_task.end());
+            std::sort(values.begin(), values.end());
+            std::vector<size_t> reversed(list_task.crbegin(), list_task.crend());
+            std::reverse(reversed.begin(), reversed.end());
+            return values == sorted && reversed == std::vector<size_t>(list_task.begin(), list_task.end()) &&
+                   list_task.size() == sorted.size();
+        };
+        std::atomic<size_t> comparisons_left(0);
+        auto throwing_less = [&comparisons_left](size_t a, size_t b) {
+            if (comparisons_left.fetch_sub(1) == 1) {
+                throw std::runtime_error("compare");
+            }
+            return a < b;
+        };
+
+        // число сравнений при полной сортировке: последние из них приходятся на дерево слияний
+        std::vector<size_t> original(list_task.begin(), list_task.end());
+        const size_t UNLIMITED = size_t(1) << 40;
+        comparisons_left = UNLIMITED;
+        list_task.parallel_sort(throwing_less, 4);
+        size_t total = UNLIMITED - comparisons_left;
+        for (size_t limit : {size_t(100), total / 2, total - 1000}) {
+            list_task.clear();
+            list_task.insert(list_task.cend(), original.begin(), original.end());
+            comparisons_left = limit;
+            bool thrown = false;
+            try {
+                list_task.parallel_sort(throwing_less, 4);
+            }
+            catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            ASSERT_TRUE_MSG(thrown, "list::parallel_sort rethrows")
+            ASSERT_TRUE_MSG(same_elements(), "list::parallel_sort keeps elements on exception")
+        }
+        comparisons_left = 1000;
+        bool thrown = false;
+        try {
+            list_task.sort(throwing_less);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        ASSERT_TRUE_MSG(thrown && same_elements(), "list::sort keeps elements on exception")
+
+        std::atomic<size_t> visited(0);
+        thrown = false;
+        try {
+            list_task.parallel_for_each([&visited](size_t&) {
+                if (++visited == 50000) {
+                    throw std::runtime_error("visit");
+                }
+            }, 4);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        ASSERT_TRUE_MSG(thrown, "list::parallel_for_each rethrows")
+        thrown = false;
+        try {
+            size_t middle = sorted[sorted.size() / 2];
+            list_task.parallel_transform_reduce(size_t(0), std::plus<size_t>(), [middle](size_t x) {
+                if (x == middle) {
+                    throw std::runtime_error("transform");
+                }
+                return x;
+            }, 4);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        ASSERT_TRUE_MSG(thrown, "list::parallel_transform_reduce rethrows")
+    }
+
+    {
+        task::list<size_t> list_task;
+        RandomFill(list_task, RandomUInt(1000, 5000));
+        list_task.radix_sort();
+        ASSERT_TRUE_MSG(std::is_sorted(list_task.begin(), list_task.end()), "list::radix_sort")
+
+        task::list<std::pair<int, size_t>> list_keyed;
+        std::list<std::pair<int, size_t>> list_std;
+        for (size_t i = RandomUInt(1000, 5000); i > 0; --i) {
+            auto val = std::make_pair(static_cast<int>(RandomUInt(2000)) - 1000, i);
+            list_keyed.push_back(val);
+            list_std.push_back(val);
+        }
+        list_keyed.radix_sort([](const std::pair<int, size_t>& p) { return p.first; });
+        list_std.sort([](const auto& a, const auto& b) { return a.first < b.first; });
+
+        ASSERT_EQUAL_MSG(list_keyed, list_std, "list::radix_sort with signed key stability")
+        ASSERT_TRUE_MSG(std::equal(list_keyed.crbegin(), list_keyed.crend(), list_std.crbegin(), list_std.crend()),
+                        "list::radix_sort links")
+    }
+
+    {
+        task::list<size_t> list_task;
+        std::list<size_t> list_std;
+        RandomFill(list_std, RandomUInt(1000, 5000), 10);
+        list_task.resize(list_std.size());
+        std::copy(list_std.begin(), list_std.end(), list_task.begin());
+
+        size_t size = list_std.size();
+        auto is_odd = [](size_t x) { return x % 2 == 1; };
+        list_std.remove_if(is_odd);
+        ASSERT_TRUE_MSG(list_task.remove_if(is_odd) == size - list_std.size(), "list::remove_if count")
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::remove_if")
+
+        size = list_std.size();
+        auto same_quarter = [](size_t a, size_t b) { return a / 4 == b / 4; };
+        list_std.unique(same_quarter);
+        ASSERT_TRUE_MSG(list_task.unique(same_quarter) == size - list_std.size(), "list::unique(pred) count")
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::unique(pred)")
+
+        size_t count = std::count(list_task.begin(), list_task.end(), list_task.back());
+        ASSERT_TRUE_MSG(list_task.remove(list_task.back()) == count, "list::remove count")
+        ASSERT_TRUE_MSG(list_task.size() == list_std.size() - count, "list::remove count")
+    }
+
+    {
+        // исключение из предиката: уже исключенные элементы удаляются, size() им соответствует
+        task::list<int> list_task;
+        for (int i = 0; i < 20; ++i) {
+            list_task.push_back(i / 2);
+        }
+        int calls = 0;
+        auto throwing = [&calls](auto... args) {
+            if (++calls == 13) {
+                throw std::runtime_error("predicate");
+            }
+            return ((args % 2 == 0) && ...);
+        };
+        bool thrown = false;
+        try {
+            list_task.remove_if(throwing);
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        std::vector<int> expected = {1, 1, 3, 3, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9};
+        ASSERT_TRUE_MSG(thrown && list_task.size() == expected.size(), "list::remove_if size after exception")
+        ASSERT_EQUAL_MSG(list_task, expected, "list::remove_if after exception")
+
+        calls = 10;
+        thrown = false;
+        try {
+            list_task.unique([&throwing](int a, int b) { return a == b && throwing(0); });
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        expected = {1, 3, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9};
+        ASSERT_TRUE_MSG(thrown && list_task.size() == expected.size(), "list::unique size after exception")
+        ASSERT_EQUAL_MSG(list_task, expected, "list::unique after exception")
+    }
+
+    {
+        // маленькие блоки, чтобы часто срабатывали деление и слияние блоков
+        task::unrolled_list<size_t, std::allocator<size_t>, 4> list_task;
+        std::list<size_t> list_std;
+        for (size_t iter = 0; iter < 20000; ++iter) {
+            size_t pos = RandomUInt(0, list_std.size());
+            auto it_task = std::next(list_task.begin(), pos);
+            auto it_std = std::next(list_std.begin(), pos);
+            size_t val = RandomUInt(100);
+            switch (RandomUInt(5)) {
+                case 0:
+                case 1:
+                    ASSERT_TRUE_MSG(*list_task.insert(it_task, val) == *list_std.insert(it_std, val),
+                                    "unrolled_list::insert result")
+                    break;
+                case 2:
+                    if (it_std != list_std.end()) {
+                        auto next_task = list_task.erase(it_task);
+                        auto next_std = list_std.erase(it_std);
+                        ASSERT_TRUE_MSG(std::distance(list_task.begin(), next_task) ==
+                                        std::distance(list_std.begin(), next_std), "unrolled_list::erase result")
+                    }
+                    break;
+                case 3: {
+                    size_t count = RandomUInt(0, std::min<size_t>(10, list_std.size() - pos));
+                    auto next_task = list_task.erase(it_task, std::next(it_task, count));
+                    auto next_std = list_std.erase(it_std, std::next(it_std, count));
+                    ASSERT_TRUE_MSG(std::distance(list_task.begin(), next_task) ==
+                                    std::distance(list_std.begin(), next_std), "unrolled_list::erase range result")
+                    break;
+                }
+                case 4:
+                    list_task.insert(it_task, 3, val);
+                    list_std.insert(it_std, 3, val);
+                    break;
+                case 5:
+                    if (TossCoin()) {
+                        list_task.push_front(val);
+                        list_std.push_front(val);
+                    } else if (!list_std.empty()) {
+                        list_task.pop_back();
+                        list_std.pop_back();
+                    }
+                    break;
+            }
+            ASSERT_TRUE_MSG(list_task.size() == list_std.size(), "unrolled_list::size")
+        }
+        ASSERT_EQUAL_MSG(list_task, list_std, "unrolled_list insert/erase")
+        ASSERT_TRUE_MSG(std::equal(list_task.crbegin(), list_task.crend(), list_std.crbegin(), list_std.crend()),
+                        "unrolled_list reverse iteration")
+
+        list_task.reverse();
+        list_std.reverse();
+        ASSERT_EQUAL_MSG(list_task, list_std, "unrolled_list::reverse")
+
+        size_t size = list_std.size();
+        list_std.remove_if([](size_t x) { return x % 3 == 0; });
+        ASSERT_TRUE_MSG(list_task.remove_if([](size_t x) { return x % 3 == 0; }) == size - list_std.size(),
+                        "unrolled_list::remove_if count")
+        ASSERT_EQUAL_MSG(list_task, list_std, "unrolled_list::remove_if")
+
+        task::unrolled_list<size_t, std::allocator<size_t>, 4> other_task;
+        std::list<size_t> other_std;
+        RandomFill(other_std, RandomUInt(1, 100), 100);
+        for (size_t x : other_std) {
+            other_task.push_back(x);
+        }
+        size_t pos = RandomUInt(1, list_std.size() - 1);
+        list_task.splice(std::next(list_task.begin(), pos), other_task);
+        list_std.splice(std::next(list_std.begin(), pos), other_std);
+        ASSERT_TRUE_MSG(other_task.empty() && list_task.size() == list_std.size(), "unrolled_list::splice sizes")
+        ASSERT_EQUAL_MSG(list_task, list_std, "unrolled_list::splice")
+
+        list_task.sort();
+        list_std.sort();
+        ASSERT_EQUAL_MSG(list_task, list_std, "unrolled_list::sort")
+        size = list_std.size();
+        list_std.unique();
+        ASSERT_TRUE_MSG(list_task.unique() == size - list_std.size(), "unrolled_list::unique count")
+        ASSERT_EQUAL_MSG(list_task, list_std, "unrolled_list::unique")
+
+        task::unrolled_list<size_t, std::allocator<size_t>, 4> copy(list_task), moved(std::move(copy));
+        ASSERT_TRUE_MSG(copy.empty(), "unrolled_list move constructor")
+        moved.resize(7);
+        list_std.resize(7);
+        ASSERT_EQUAL_MSG(moved, list_std, "unrolled_list::resize")
+        std::list<size_t> merged_std(list_task.cbegin(), list_task.cend());
+        moved.merge(list_task);
+        list_std.merge(merged_std);
+        ASSERT_TRUE_MSG(list_task.empty(), "unrolled_list::merge empties other")
+        ASSERT_EQUAL_MSG(moved, list_std, "unrolled_list::merge")
+    }
+
+    {
+        // unrolled_list: исключение из конструктора T не оставляет в списке пустых блоков
+        using List = task::unrolled_list<CopyThrower, std::allocator<CopyThrower>, 4>;
+        auto consistent = [](const List& list, const std::vector<size_t>& expected) {
+            std::vector<size_t> values;
+            for (auto it = list.cbegin(); it != list.cend(); ++it) {
+                values.push_back(it->value);
+            }
+            return values == expected && list.size() == expected.size();
+        };
+        auto throws = [](auto&& f, int copies) {
+            CopyThrower::copies_left = copies;
+            bool thrown = false;
+            try {
+                f();
+            } catch (const std::runtime_error&) {
+                thrown = true;
+            }
+            CopyThrower::copies_left = -1;
+            return thrown;
+        };
+        CopyThrower value(100);
+        List list;
+        ASSERT_TRUE_MSG(throws([&] { list.push_back(value); }, 0), "unrolled_list: copy throws")
+        ASSERT_TRUE_MSG(list.empty() && list.cbegin() == list.cend(), "unrolled_list: empty after throwing push_back")
+        for (size_t i = 0; i < 4; ++i) {
+            list.push_back(CopyThrower(i));
+        }
+        const std::vector<size_t> full = {0, 1, 2, 3};
+        ASSERT_TRUE_MSG(throws([&] { list.push_back(value); }, 0) && consistent(list, full),
+                        "unrolled_list: throwing push_back into a new block")
+        ASSERT_TRUE_MSG(throws([&] { list.push_front(value); }, 0) && consistent(list, full),
+                        "unrolled_list: throwing push_front into a new block")
+        ASSERT_TRUE_MSG(throws([&] { list.insert(std::next(list.cbegin()), value); }, 0) && consistent(list, full),
+                        "unrolled_list: throwing insert before split")
+        ASSERT_TRUE_MSG(throws([&] { list.insert(std::next(list.cbegin()), value); }, 1) && consistent(list, full),
+                        "unrolled_list: throwing move during split")
+        list.insert(std::next(list.cbegin()), value);
+        ASSERT_TRUE_MSG(consistent(list, {0, 100, 1, 2, 3}), "unrolled_list: insert after failures")
+
+        // слияние блоков после удаления: при исключении значения не теряются
+        list.erase(list.cbegin());
+        ASSERT_TRUE_MSG(throws([&] { list.erase(list.cbegin()); }, 0), "unrolled_list: throwing merge of blocks")
+        ASSERT_TRUE_MSG(consistent(list, {1, 2, 3}), "unrolled_list: consistent after throwing erase")
+    }
+
+    {
+        // unrolled_list: копия получает аллокатор select_on_container_copy_construction
+        task::unrolled_list<int, TaggedAllocator<int, true>> propagating(TaggedAllocator<int, true>(5));
+        task::unrolled_list<int, TaggedAllocator<int, false>> sticky(TaggedAllocator<int, false>(5));
+        propagating.push_back(1);
+        sticky.push_back(1);
+        tag_mismatches = 0;
+        {
+            task::unrolled_list<int, TaggedAllocator<int, true>> propagating_copy(propagating);
+            task::unrolled_list<int, TaggedAllocator<int, false>> sticky_copy(sticky);
+            ASSERT_TRUE_MSG(propagating_copy.get_allocator().id == 5 && sticky_copy.get_allocator().id == -1,
+                            "unrolled_list: copy allocator")
+        }
+        ASSERT_TRUE_MSG(tag_mismatches == 0, "unrolled_list: copy frees through its own allocator")
+
+        // присваивание и обмен: аллокатор передается по propagate_on_container_*
+        {
+            task::unrolled_list<int, TaggedAllocator<int, true>> a(TaggedAllocator<int, true>(1));
+            task::unrolled_list<int, TaggedAllocator<int, true>> b(TaggedAllocator<int, true>(2));
+            a.push_back(1);
+            a.push_back(2);
+            b.push_back(3);
+            b = a;
+            ASSERT_TRUE_MSG(b.get_allocator().id == 1 && b.size() == 2 && b.back() == 2,
+                            "unrolled_list: propagate_on_container_copy_assignment")
+            b = task::unrolled_list<int, TaggedAllocator<int, true>>(3, 7, TaggedAllocator<int, true>(3));
+            ASSERT_TRUE_MSG(b.get_allocator().id == 3 && b.size() == 3, "unrolled_list: propagate_on_container_move_assignment")
+            a.swap(b);
+            ASSERT_TRUE_MSG(a.get_allocator().id == 3 && b.get_allocator().id == 1 && b.back() == 2,
+                            "unrolled_list: propagate_on_container_swap")
+        }
+        {
+            task::unrolled_list<int, TaggedAllocator<int, false>> a(TaggedAllocator<int, false>(1));
+            task::unrolled_list<int, TaggedAllocator<int, false>> b(TaggedAllocator<int, false>(2));
+            a.push_back(1);
+            a.push_back(2);
+            b.push_back(3);
+            b = a;
+            ASSERT_TRUE_MSG(b.get_allocator().id == 2 && b.size() == 2 && b.back() == 2,
+                            "unrolled_list: copy assignment keeps allocator")
+            b = task::unrolled_list<int, TaggedAllocator<int, false>>(3, 7, TaggedAllocator<int, false>(3));
+            ASSERT_TRUE_MSG(b.get_allocator().id == 2 && b.size() == 3 && b.front() == 7,
+                            "unrolled_list: move assignment with unequal allocators")
+            task::unrolled_list<int, TaggedAllocator<int, false>> c(TaggedAllocator<int, false>(2));
+            c = std::move(b);
+            ASSERT_TRUE_MSG(c.size() == 3 && b.empty(), "unrolled_list: move assignment with equal allocators")
+        }
+        ASSERT_TRUE_MSG(tag_mismatches == 0, "unrolled_list: memory is freed by the allocator it came from")
+    }
+
+    {
+        // unrolled_list: значения создаются через аллокатор списка и получают его ресурс
+        std::pmr::unsynchronized_pool_resource pool;
+        task::unrolled_list<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>, 4> list_task(&pool);
+        for (int i = 0; i < 10; ++i) {
+            list_task.emplace_back("a string long enough to skip the small buffer optimization");
+        }
+        list_task.insert(std::next(list_task.cbegin(), 2), std::pmr::string("moved in"));
+        bool own_resource = true;
+        for (auto it = list_task.cbegin(); it != list_task.cend(); ++it) {
+            own_resource = own_resource && it->get_allocator().resource() == &pool;
+        }
+        ASSERT_TRUE_MSG(own_resource && list_task.size() == 11, "unrolled_list passes resource to values")
+
+        // вставка нескольких копий значения из того же блока, который делится при вставке
+        task::unrolled_list<std::string, std::allocator<std::string>, 4> strings;
+        for (int i = 0; i < 4; ++i) {
+            strings.push_back(std::string(40, static_cast<char>('a' + i)));
+        }
+        strings.insert(std::next(strings.cbegin()), 6, *std::next(strings.cbegin(), 3));
+        std::vector<std::string> expected = {std::string(40, 'a')};
+        expected.insert(expected.end(), 6, std::string(40, 'd'));
+        for (int i = 1; i < 4; ++i) {
+            expected.push_back(std::string(40, static_cast<char>('a' + i)));
+        }
+        ASSERT_EQUAL_MSG(strings, expected, "unrolled_list::insert count of own value")
+    }
+
+    {
+        using OwnerList = task::intrusive_list<Timer, task::member_hook<Timer, task::auto_unlink_list_hook, &Timer::by_owner>>;
+        std::vector<Timer> timers;
+        std::list<size_t> list_std;
+        for (size_t i = RandomUInt(100, 500); i > 0; --i) {
+            timers.emplace_back(RandomUInt(50));
+        }
+        task::intrusive_list<Timer> list_task, other_task;
+        for (size_t i = 0; i < timers.size(); ++i) {
+            if (i % 3 == 0) {
+                other_task.push_front(timers[i]);
+            } else {
+                list_task.push_back(timers[i]);
+                list_std.push_back(timers[i].deadline);
+            }
+        }
+        auto deadlines = [](const task::intrusive_list<Timer>& list) {
+            std::list<size_t> result;
+            for (auto it = list.cbegin(); it != list.cend(); ++it) {
+                result.push_back(it->deadline);
+            }
+            return result;
+        };
+        ASSERT_TRUE_MSG(deadlines(list_task) == list_std && list_task.size() == list_std.size(), "intrusive_list::push_back")
+
+        // удаление по ссылке на объект, без поиска
+        Timer& victim = *std::next(list_task.begin(), list_task.size() / 2);
+        list_std.erase(std::next(list_std.begin(), list_task.size() / 2));
+        list_task.erase(victim);
+        ASSERT_TRUE_MSG(!victim.is_linked() && deadlines(list_task) == list_std, "intrusive_list::erase(T&)")
+        list_task.push_front(victim);
+        list_std.push_front(victim.deadline);
+        ASSERT_TRUE_MSG(&*list_task.iterator_to(victim) == &victim, "intrusive_list::iterator_to")
+
+        std::list<size_t> other_std = deadlines(other_task);
+        list_task.sort();
+        other_task.sort();
+        list_std.sort();
+        other_std.sort();
+        ASSERT_TRUE_MSG(deadlines(list_task) == list_std, "intrusive_list::sort")
+        list_task.merge(other_task);
+        list_std.merge(other_std);
+        ASSERT_TRUE_MSG(other_task.empty() && deadlines(list_task) == list_std, "intrusive_list::merge")
+        ASSERT_TRUE_MSG(std::is_sorted(list_task.begin(), list_task.end()), "intrusive_list::merge order")
+
+        size_t size = list_std.size();
+        list_std.unique();
+        ASSERT_TRUE_MSG(list_task.unique() == size - list_std.size() && deadlines(list_task) == list_std,
+                        "intrusive_list::unique")
+        size_t removed = list_task.remove_if([](const Timer& t) { return t.deadline % 2 == 0; });
+        list_std.remove_if([](size_t d) { return d % 2 == 0; });
+        ASSERT_TRUE_MSG(removed > 0 && deadlines(list_task) == list_std && list_task.size() == list_std.size(),
+                        "intrusive_list::remove_if")
+
+        list_task.reverse();
+        list_std.reverse();
+        ASSERT_TRUE_MSG(deadlines(list_task) == list_std, "intrusive_list::reverse")
+
+        other_task.splice(other_task.cend(), list_task, list_task.cbegin());
+        ASSERT_TRUE_MSG(other_task.size() == 1 && list_task.size() == list_std.size() - 1, "intrusive_list::splice(it)")
+        other_task.splice(other_task.cend(), list_task);
+        ASSERT_TRUE_MSG(list_task.empty() && deadlines(other_task) == list_std, "intrusive_list::splice")
+        other_task.clear();
+        ASSERT_TRUE_MSG(std::none_of(timers.begin(), timers.end(), [](const Timer& t) { return t.is_linked(); }),
+                        "intrusive_list::clear unlinks")
+
+        // безопасный режим: уничтоженный объект сам уходит из списка
+        OwnerList owned;
+        {
+            Timer first(1), second(2), third(3);
+            owned.push_back(first);
+            owned.push_back(second);
+            owned.push_back(third);
+            {
+                Timer temporary(4);
+                owned.push_front(temporary);
+                ASSERT_TRUE_MSG(owned.size() == 4, "intrusive_list auto_unlink size")
+            }
+            ASSERT_TRUE_MSG(owned.size() == 3 && owned.front().deadline == 1, "intrusive_list auto_unlink")
+            second.by_owner.unlink();
+            ASSERT_TRUE_MSG(owned.size() == 2 && owned.back().deadline == 3, "intrusive_list hook::unlink")
+        }
+        ASSERT_TRUE_MSG(owned.empty(), "intrusive_list auto_unlink on scope exit")
+    }
+
+    {
+        task::xor_list<size_t> list_task;
+        std::list<size_t> list_std;
+        for (size_t iter = 0; iter < 5000; ++iter) {
+            size_t val = RandomUInt(1000);
+            switch (RandomUInt(6)) {
+                case 0:
+                    list_task.push_back(val);
+                    list_std.push_back(val);
+                    break;
+                case 1:
+                    list_task.push_front(val);
+                    list_std.push_front(val);
+                    break;
+                case 2:
+                    list_task.pop_back();
+                    if (!list_std.empty()) {
+                        list_std.pop_back();
+                    }
+                    break;
+                case 3:
+                    list_task.pop_front();
+                    if (!list_std.empty()) {
+                        list_std.pop_front();
+                    }
+                    break;
+                case 4: {
+                    size_t pos = RandomUInt(0, list_std.size());
+                    auto it = list_task.insert(std::next(list_task.cbegin(), pos), val);
+                    list_std.insert(std::next(list_std.begin(), pos), val);
+                    ASSERT_TRUE_MSG(*it == val && static_cast<size_t>(std::distance(list_task.begin(), it)) == pos,
+                                    "xor_list::insert")
+                    break;
+                }
+                case 5:
+                    if (!list_std.empty()) {
+                        size_t pos = RandomUInt(0, list_std.size() - 1);
+                        auto it = list_task.erase(std::next(list_task.cbegin(), pos));
+                        list_std.erase(std::next(list_std.begin(), pos));
+                        ASSERT_TRUE_MSG(static_cast<size_t>(std::distance(list_task.begin(), it)) == pos,
+                                        "xor_list::erase")
+                    }
+                    break;
+                case 6:
+                    list_task.reverse();
+                    list_std.reverse();
+                    break;
+            }
+        }
+        ASSERT_TRUE_MSG(list_task.size() == list_std.size(), "xor_list::size")
+        ASSERT_EQUAL_MSG(list_task, list_std, "xor_list")
+        ASSERT_TRUE_MSG(std::equal(list_task.crbegin(), list_task.crend(), list_std.crbegin(), list_std.crend()),
+                        "xor_list reverse iteration")
+
+        for (size_t pos : {size_t(0), list_std.size() / 2, list_std.size()}) {
+            task::xor_list<size_t> other_task = {1, 2, 3};
+            std::list<size_t> other_std = {1, 2, 3};
+            list_task.splice(std::next(list_task.cbegin(), pos), other_task);
+            list_std.splice(std::next(list_std.begin(), pos), other_std);
+            ASSERT_TRUE_MSG(other_task.empty() && list_task.size() == list_std.size(), "xor_list::splice sizes")
+            ASSERT_EQUAL_MSG(list_task, list_std, "xor_list::splice")
+        }
+        list_task.reverse();
+        list_std.reverse();
+        ASSERT_TRUE_MSG(list_task.front() == list_std.front() && list_task.back() == list_std.back(),
+                        "xor_list::reverse ends")
+
+        task::xor_list<size_t> copy = list_task;
+        task::xor_list<size_t> moved = std::move(copy);
+        ASSERT_TRUE_MSG(copy.empty(), "xor_list move")
+        ASSERT_EQUAL_MSG(moved, list_std, "xor_list copy")
+    }
+
+    {
+        task::list<size_t> list_task;
+        std::list<size_t> list_std;
+        RandomFill(list_std, RandomUInt(2000, 5000));
+        list_task.insert(list_task.cend(), list_std.begin(), list_std.end());
+        // сортировка переставляет указатели: соседние элементы оказываются в случайных местах кучи
+        list_task.sort();
+        list_std.sort();
+        ASSERT_TRUE_MSG(list_task.address_jump_score() > 0.5, "list::address_jump_score scattered")
+
+        list_task.compact();
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::compact keeps order")
+        ASSERT_TRUE_MSG(list_task.address_jump_score() == 0, "list::compact contiguous")
+        auto it = list_task.begin();
+        const char* first = reinterpret_cast<const char*>(&*it);
+        const char* second = reinterpret_cast<const char*>(&*++it);
+        ptrdiff_t stride = second - first;
+        for (size_t i = 1; it != list_task.end(); ++i, ++it) {
+            ASSERT_TRUE_MSG(reinterpret_cast<const char*>(&*it) == first + stride * i,
+                            "list::compact elements in iteration order")
+        }
+
+        // итераторы, полученные после compact(), действительны; элементы блока удаляются по одному
+        list_task.erase(std::next(list_task.begin(), 10));
+        list_std.erase(std::next(list_std.begin(), 10));
+        list_task.erase(std::next(list_task.begin(), 20), std::next(list_task.begin(), 40));
+        list_std.erase(std::next(list_std.begin(), 20), std::next(list_std.begin(), 40));
+        list_task.pop_front();
+        list_std.pop_front();
+        list_task.push_back(1);
+        list_std.push_back(1);
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::compact then erase")
+
+        {
+            // блок живет, пока его элементы есть хотя бы в одном списке
+            task::list<size_t> other(50, 7);
+            other.compact();
+            list_task.splice(std::next(list_task.cbegin(), 5), other);
+            list_std.insert(std::next(list_std.begin(), 5), 50, 7);
+        }
+        list_task.compact();
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::compact after splice")
+
+        task::list<std::string> strings;
+        for (size_t i = 0; i < 100; ++i) {
+            strings.push_front(std::string(40, 'a' + i % 26));
+        }
+        strings.compact();
+        ASSERT_TRUE_MSG(strings.size() == 100 && strings.back() == std::string(40, 'a'), "list::compact strings")
+
+        // уплотнение по порогу выполняется только явно, после size() изменений
+        list_task.sort(std::greater<size_t>());
+        list_std.sort(std::greater<size_t>());
+        ASSERT_TRUE_MSG(list_task.address_jump_score() > 0.5, "list::address_jump_score reversed")
+        list_task.auto_compact(0.5);
+        ASSERT_TRUE_MSG(!list_task.compact_if_scattered(), "list::compact_if_scattered waits for churn")
+        const size_t* front_before = &list_task.front();
+        for (size_t i = list_task.size() + 1024; i > 0; --i) {
+            list_task.push_back(i);
+            list_task.pop_back();
+        }
+        ASSERT_TRUE_MSG(&list_task.front() == front_before, "list: push and pop never relocate elements")
+        ASSERT_TRUE_MSG(list_task.compact_if_scattered(), "list::compact_if_scattered")
+        ASSERT_TRUE_MSG(list_task.address_jump_score() < 0.01, "list::auto_compact")
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::auto_compact keeps order")
+    }
+
+    {
+        task::list<size_t> list_task;
+        std::vector<size_t> vector_std;
+        ASSERT_TRUE_MSG(list_task.nth(0) == list_task.end() && list_task.index_of(list_task.cend()) == 0,
+                        "list::nth without index")
+        list_task.enable_index();
+        for (size_t iter = 0; iter < 3000; ++iter) {
+            size_t pos = RandomUInt(0, vector_std.size());
+            size_t val = RandomUInt(1000);
+            switch (RandomUInt(7)) {
+                case 0:
+                case 1:
+                    list_task.insert(list_task.nth(pos), val);
+                    vector_std.insert(vector_std.begin() + pos, val);
+                    break;
+                case 2:
+                    if (pos < vector_std.size()) {
+                        list_task.erase(list_task.nth(pos));
+                        vector_std.erase(vector_std.begin() + pos);
+                    }
+                    break;
+                case 3: {
+                    size_t count = RandomUInt(0, std::min<size_t>(20, vector_std.size() - pos));
+                    list_task.erase(list_task.nth(pos), list_task.nth(pos + count));
+                    vector_std.erase(vector_std.begin() + pos, vector_std.begin() + pos + count);
+                    break;
+                }
+                case 4:
+                    list_task.insert(list_task.nth(pos), {val, val + 1, val + 2});
+                    vector_std.insert(vector_std.begin() + pos, {val, val + 1, val + 2});
+                    break;
+                case 5: {
+                    task::list<size_t> other(RandomUInt(1, 10), val);
+                    if (TossCoin()) {
+                        other.enable_index();
+                    }
+                    vector_std.insert(vector_std.begin() + pos, other.size(), val);
+                    list_task.splice(list_task.nth(pos), other);
+                    break;
+                }
+                case 6:
+                    list_task.push_front(val);
+                    vector_std.insert(vector_std.begin(), val);
+                    list_task.pop_back();
+                    vector_std.pop_back();
+                    break;
+                case 7:
+                    if (iter % 100 == 0) {
+                        list_task.sort();
+                        std::stable_sort(vector_std.begin(), vector_std.end());
+                    }
+                    break;
+            }
+            ASSERT_TRUE_MSG(list_task.size() == vector_std.size(), "list index size")
+            if (!vector_std.empty()) {
+                size_t k = RandomUInt(0, vector_std.size() - 1);
+                ASSERT_TRUE_MSG(list_task.at(k) == vector_std[k], "list::at with index")
+                ASSERT_TRUE_MSG(list_task.index_of(list_task.nth(k)) == k, "list::index_of with index")
+            }
+        }
+        ASSERT_EQUAL_MSG(list_task, vector_std, "list with index")
+        ASSERT_TRUE_MSG(list_task.nth(list_task.size()) == list_task.end(), "list::nth(size())")
+
+        size_t removed = list_task.remove_if([](size_t x) { return x % 2 == 0; });
+        vector_std.erase(std::remove_if(vector_std.begin(), vector_std.end(), [](size_t x) { return x % 2 == 0; }),
+                         vector_std.end());
+        ASSERT_TRUE_MSG(removed > 0 && list_task.at(vector_std.size() / 2) == vector_std[vector_std.size() / 2],
+                        "list::at after remove_if")
+
+        const task::list<size_t> copy(list_task);
+        ASSERT_TRUE_MSG(copy.has_index() && copy.at(copy.size() - 1) == vector_std.back(), "list copy keeps index")
+        list_task.disable_index();
+        bool thrown = false;
+        try {
+            list_task.at(list_task.size());
+        } catch (const std::out_of_range&) {
+            thrown = true;
+        }
+        ASSERT_TRUE_MSG(thrown && list_task.at(1) == vector_std[1], "list::at without index")
+    }
+
+    {
+        // сравнение с простой моделью: список пар в порядке использования
+        const size_t capacity = 8;
+        std::list<std::pair<size_t, size_t>> model;
+        std::vector<size_t> evicted_task, evicted_model;
+        task::lru_cache<size_t, size_t> cache(capacity, [&](const size_t& key, size_t&) { evicted_task.push_back(key); });
+        auto find = [&](size_t key) {
+            return std::find_if(model.begin(), model.end(), [key](const auto& p) { return p.first == key; });
+        };
+        for (size_t iter = 0; iter < 20000; ++iter) {
+            size_t key = RandomUInt(20);
+            size_t val = RandomUInt(1000);
+            auto it = find(key);
+            switch (RandomUInt(3)) {
+                case 0:
+                case 1: {
+                    bool inserted = cache.put(key, val);
+                    ASSERT_TRUE_MSG(inserted == (it == model.end()), "lru_cache::put result")
+                    if (it != model.end()) {
+                        model.erase(it);
+                    } else if (model.size() == capacity) {
+                        evicted_model.push_back(model.back().first);
+                        model.pop_back();
+                    }
+                    model.emplace_front(key, val);
+                    break;
+                }
+                case 2: {
+                    size_t* found = cache.get(key);
+                    ASSERT_TRUE_MSG((found == nullptr) == (it == model.end()), "lru_cache::get presence")
+                    if (found != nullptr) {
+                        ASSERT_TRUE_MSG(*found == it->second, "lru_cache::get value")
+                        model.splice(model.begin(), model, it);
+                    }
+                    break;
+                }
+                case 3:
+                    ASSERT_TRUE_MSG(cache.erase(key) == (it != model.end()), "lru_cache::erase")
+                    if (it != model.end()) {
+                        model.erase(it);
+                    }
+                    break;
+            }
+            ASSERT_TRUE_MSG(cache.size() == model.size(), "lru_cache::size")
+        }
+        ASSERT_TRUE_MSG(std::equal(cache.cbegin(), cache.cend(), model.begin(), model.end()), "lru_cache order")
+        ASSERT_TRUE_MSG(evicted_task == evicted_model, "lru_cache eviction callback")
+        cache.clear();
+        ASSERT_TRUE_MSG(cache.empty() && !cache.contains(1), "lru_cache::clear")
+    }
+
+    {
+        // после заполнения get и put не выделяют память
+        using Alloc = task::counting_allocator<std::allocator<std::pair<size_t, size_t>>>;
+        task::allocation_stats stats;
+        task::lru_cache<size_t, size_t, std::hash<size_t>, std::equal_to<size_t>, Alloc>
+            cache(64, {}, {}, {}, Alloc(&stats));
+        for (size_t i = 0; i < 256; ++i) {
+            cache.put(i, i);
+        }
+        size_t before = stats.allocations;
+        for (size_t i = 0; i < 10000; ++i) {
+            size_t key = RandomUInt(300);
+            if (cache.get(key) == nullptr) {
+                cache.put(key, i);
+            }
+        }
+        cache.erase(cache.cbegin()->first);
+        ASSERT_TRUE_MSG(stats.allocations == before, "lru_cache steady state without allocations")
+    }
+
+    {
+        task::list<size_t> list_task, other;
+        list_task.insert(list_task.cend(), {0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+        other.insert(other.cend(), {10, 11, 12, 13});
+        std::list<size_t> list_std = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+        std::list<size_t> other_std = {10, 11, 12, 13};
+        list_task.enable_index();
+
+        list_task.splice(std::next(list_task.cbegin(), 3), other, std::next(other.cbegin()));
+        list_std.splice(std::next(list_std.begin(), 3), other_std, std::next(other_std.begin()));
+        ASSERT_TRUE_MSG(list_task.size() == 11 && other.size() == 3, "list::splice(it) sizes")
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::splice(it)")
+        ASSERT_EQUAL_MSG(other, other_std, "list::splice(it) source")
+        ASSERT_TRUE_MSG(list_task.at(3) == 11 && list_task.index_of(std::next(list_task.cbegin(), 4)) == 4,
+                        "list::splice(it) index")
+
+        list_task.splice(list_task.cend(), other, other.cbegin(), std::prev(other.cend()));
+        list_std.splice(list_std.end(), other_std, other_std.begin(), std::prev(other_std.end()));
+        ASSERT_TRUE_MSG(list_task.size() == 13 && other.size() == 1, "list::splice(range) sizes")
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::splice(range)")
+
+        // внутри одного списка
+        list_task.splice(list_task.cbegin(), list_task, std::next(list_task.cbegin(), 5), std::next(list_task.cbegin(), 9));
+        list_std.splice(list_std.begin(), list_std, std::next(list_std.begin(), 5), std::next(list_std.begin(), 9));
+        list_task.splice(list_task.cend(), list_task, list_task.cbegin());
+        list_std.splice(list_std.end(), list_std, list_std.begin());
+        list_task.splice(std::next(list_task.cbegin()), list_task, list_task.cbegin());
+        list_std.splice(std::next(list_std.begin()), list_std, list_std.begin());
+        ASSERT_EQUAL_MSG(list_task, list_std, "list::splice within list")
+        ASSERT_TRUE_MSG(std::equal(list_task.crbegin(), list_task.crend(), list_std.crbegin(), list_std.crend()),
+                        "list::splice within list links")
+        ASSERT_TRUE_MSG(list_task.at(7) == *std::next(list_std.begin(), 7), "list::splice within list index")
+    }
+
+    {
+        // несколько производителей, потребитель забирает элементы по одному и целыми цепочками
+        const size_t PRODUCERS = 4;
+        const size_t PER_PRODUCER = 20000;
+        task::mpsc_list_queue<std::pair<size_t, size_t>> queue;
+        ASSERT_TRUE_MSG(queue.empty() && queue.size() == 0, "mpsc_list_queue empty")
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < PRODUCERS; ++p) {
+            producers.emplace_back([&queue, p, PER_PRODUCER]() {
+                for (size_t i = 0; i < PER_PRODUCER; ++i) {
+                    queue.emplace_back(p, i);
+                }
+            });
+        }
+        task::list<std::pair<size_t, size_t>> received;
+        std::pair<size_t, size_t> value;
+        while (received.size() < PRODUCERS * PER_PRODUCER) {
+            if (received.size() % 3 == 0 && queue.pop_front(value)) {
+                received.push_back(value);
+            }
+            else {
+                queue.drain(received);
+            }
+        }
+        for (auto& producer : producers) {
+            producer.join();
+        }
+        ASSERT_TRUE_MSG(queue.empty() && !queue.pop_front(value) && queue.drain(received) == 0,
+                        "mpsc_list_queue drained")
+        std::vector<size_t> expected(PRODUCERS, 0);
+        bool ordered = true;
+        for (const auto& item : received) {
+            ordered = ordered && item.second == expected[item.first]++;
+        }
+        ASSERT_TRUE_MSG(ordered, "mpsc_list_queue keeps per-producer order")
+        ASSERT_TRUE_MSG(static_cast<size_t>(std::distance(received.crbegin(), received.crend())) == received.size(),
+                        "mpsc_list_queue drain links")
+    }
+
+    {
+        task::mpsc_list_queue<std::string> queue;
+        queue.push_back("a");
+        std::string b = "b";
+        queue.push_back(b);
+        queue.emplace_back(3, 'c');
+        std::string value;
+        ASSERT_TRUE_MSG(queue.size() == 3 && queue.pop_front(value) && value == "a", "mpsc_list_queue::pop_front")
+        task::list<std::string> to;
+        to.push_back("z");
+        ASSERT_TRUE_MSG(queue.drain(to) == 2 && to.size() == 3 && to.back() == "ccc" && *std::next(to.cbegin()) == "b",
+                        "mpsc_list_queue::drain")
+        queue.push_back("left in queue"); // освобождается деструктором очереди
+    }
+
+    {
+        // аллокаторы, передаваемые при копировании, перемещении и обмене
+        using Propagating = TaggedAllocator<int, true>;
+        using Sticky = TaggedAllocator<int, false>;
+        tag_mismatches = 0;
+        {
+            task::list<int, Propagating> a(Propagating(1)), b(Propagating(2));
+            a.insert(a.cend(), {1, 2, 3});
+            b.insert(b.cend(), {4, 5});
+            b.enable_index();
+            a.compact();
+            task::list<int, Propagating> copy(a);
+            ASSERT_TRUE_MSG(copy.get_allocator().id == 1, "select_on_container_copy_construction")
+            b = a;
+            ASSERT_TRUE_MSG(b.get_allocator().id == 1 && b.has_index() && b.at(2) == 3, "propagate_on_container_copy_assignment")
+            b = task::list<int, Propagating>(3, 7, Propagating(3));
+            ASSERT_TRUE_MSG(b.get_allocator().id == 3 && b.size() == 3, "propagate_on_container_move_assignment")
+            a.swap(b);
+            ASSERT_TRUE_MSG(a.get_allocator().id == 3 && b.get_allocator().id == 1 && b.back() == 3,
+                            "propagate_on_container_swap")
+        }
+        {
+            task::list<int, Sticky> a(Sticky(1)), b(Sticky(2));
+            a.insert(a.cend(), {1, 2, 3});
+            b.insert(b.cend(), {4, 5, 6, 7});
+            a.compact();
+            task::list<int, Sticky> copy(a);
+            ASSERT_TRUE_MSG(copy.get_allocator().id == -1, "select_on_container_copy_construction without propagation")
+            b = a;
+            ASSERT_TRUE_MSG(b.get_allocator().id == 2 && b.size() == 3 && b.back() == 3, "copy assignment keeps allocator")
+            b = std::move(copy);
+            ASSERT_TRUE_MSG(b.get_allocator().id == 2 && b.size() == 3 && b.front() == 1,
+                            "move assignment with unequal allocators")
+            task::list<int, Sticky> moved(std::move(a), Sticky(4));
+            ASSERT_TRUE_MSG(moved.get_allocator().id == 4 && moved.size() == 3 && moved.back() == 3,
+                            "move construction with another allocator")
+            task::list<int, Sticky> same(std::move(moved), Sticky(4));
+            ASSERT_TRUE_MSG(same.size() == 3 && moved.empty(), "move construction with equal allocator")
+        }
+        ASSERT_TRUE_MSG(tag_mismatches == 0, "memory is freed by the allocator it came from")
+
+        // после замены аллокатора и реестр блоков compact() выделяет память только новым аллокатором
+        {
+            task::list<int, Propagating> a(Propagating(5)), b(Propagating(6));
+            a.insert(a.cend(), {1, 2, 3});
+            b.insert(b.cend(), {4, 5});
+            a.compact();
+            b = a;
+            retired_tag = 6;
+            b.compact();
+            b.push_back(4);
+            b.compact();
+            ASSERT_TRUE_MSG(b.get_allocator().id == 5 && b.size() == 4 && b.back() == 4, "compact after copy assignment")
+
+            task::list<int, Propagating> c(Propagating(7));
+            c.insert(c.cend(), {8, 9});
+            c.compact();
+            c = std::move(b);
+            retired_tag = 7;
+            c.push_front(0);
+            c.compact();
+            ASSERT_TRUE_MSG(c.get_allocator().id == 5 && c.size() == 5 && c.front() == 0, "compact after move assignment")
+
+            task::list<int, Propagating> d(Propagating(8));
+            d.insert(d.cend(), {10, 11, 12});
+            c.swap(d);
+            retired_tag = -2;
+            c.compact();
+            d.compact();
+            ASSERT_TRUE_MSG(c.get_allocator().id == 8 && d.get_allocator().id == 5 && c.size() == 3 && d.size() == 5,
+                            "compact after swap")
+        }
+        retired_tag = -2;
+        ASSERT_TRUE_MSG(tag_mismatches == 0, "arena registry follows the list allocator")
+    }
+
+    {
+        // pmr: элементы и их собственные данные берут память из ресурса списка
+        char buffer[1 << 14];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        task::pmr::list<std::pmr::string> list_task(&arena);
+        for (int i = 0; i < 10; ++i) {
+            list_task.emplace_back("a string long enough to skip the small buffer optimization");
+        }
+        list_task.push_back(std::pmr::string("moved in"));
+        ASSERT_TRUE_MSG(list_task.back().get_allocator().resource() == &arena, "pmr::list passes resource to elements")
+        ASSERT_TRUE_MSG(list_task.front().get_allocator().resource() == &arena, "pmr::list emplace uses resource")
+
+        task::pmr::list<std::pmr::string> copy(list_task);
+        ASSERT_TRUE_MSG(copy.get_allocator().resource() == std::pmr::get_default_resource() &&
+                        copy.front().get_allocator().resource() == std::pmr::get_default_resource(),
+                        "pmr::list copy uses default resource")
+        std::pmr::unsynchronized_pool_resource pool;
+        task::pmr::list<std::pmr::string> pooled(&pool);
+        pooled = std::move(list_task);
+        ASSERT_TRUE_MSG(pooled.size() == 11 && pooled.get_allocator().resource() == &pool &&
+                        pooled.front().get_allocator().resource() == &pool, "pmr::list move between resources")
+        ASSERT_EQUAL_MSG(pooled, copy, "pmr::list contents")
+        task::pmr::list<std::pmr::string> other(&pool);
+        pooled.swap(other);
+        ASSERT_TRUE_MSG(pooled.empty() && other.size() == 11, "pmr::list swap with equal resources")
+    }
+
+    {
+        // версии persistent_list разделяют хвосты и не меняются при создании новых
+        task::persistent_list<std::string> empty;
+        ASSERT_TRUE_MSG(empty.empty() && empty.size() == 0 && empty.cbegin() == empty.cend(), "persistent_list empty")
+        std::vector<std::string> values = {"b", "c", "d"};
+        task::persistent_list<std::string> base(values.begin(), values.end());
+        task::persistent_list<std::string> first = base.push_front("a");
+        task::persistent_list<std::string> second = base.emplace_front(2, 'x');
+        task::persistent_list<std::string> snapshot = first.snapshot();
+        ASSERT_EQUAL_MSG(base, values, "persistent_list from range")
+        ASSERT_TRUE_MSG(first.size() == 4 && first.front() == "a" && second.front() == "xx", "persistent_list::push_front")
+        ASSERT_TRUE_MSG(first.pop_front().same_as(base) && second.pop_front().same_as(base), "persistent_list shares tail")
+        ASSERT_TRUE_MSG(snapshot.same_as(first) && &*std::next(first.cbegin()) == &*base.cbegin(), "persistent_list snapshot")
+        first = first.pop_front().pop_front();
+        ASSERT_TRUE_MSG(first.size() == 2 && first.front() == "c" && base.size() == 3 && snapshot.size() == 4,
+                        "persistent_list old versions unchanged")
+        base = std::move(second);
+        base = base;
+        ASSERT_TRUE_MSG(base.size() == 4 && base.front() == "xx" && snapshot.front() == "a", "persistent_list assignment")
+
+        // длинная цепочка освобождается без рекурсии
+        task::persistent_list<size_t> long_list;
+        for (size_t i = 0; i < 1000000; ++i) {
+            long_list = long_list.push_front(i);
+        }
+        task::persistent_list<size_t> tail = long_list;
+        for (size_t i = 0; i < 10; ++i) {
+            tail = tail.pop_front();
+        }
+        long_list = task::persistent_list<size_t>();
+        ASSERT_TRUE_MSG(tail.size() == 999990 && tail.front() == 999989, "persistent_list long chain")
+    }
+
+    {
+        // параллельный обход и свертка: результат не зависит от числа потоков
+        const size_t n = 50000;
+        task::list<double> list_task;
+        std::vector<double> values;
+        for (size_t i = 0; i < n; ++i) {
+            values.push_back(1.0 / (1 + RandomUInt(1000)));
+        }
+        list_task.insert(list_task.cend(), values.begin(), values.end());
+        list_task.parallel_for_each([](double& x) { x *= 3; }, 4);
+        for (double& x : values) {
+            x *= 3;
+        }
+        ASSERT_EQUAL_MSG(list_task, values, "list::parallel_for_each")
+
+        auto sum = [&list_task](size_t threads) {
+            return list_task.parallel_transform_reduce(0.5, std::plus<double>(), [](double x) { return x * x; }, threads);
+        };
+        double sequential = sum(1);
+        bool same = true;
+        for (size_t threads : {2, 3, 8, 64}) {
+            same = same && sum(threads) == sequential;
+        }
+        list_task.enable_index();
+        same = same && sum(5) == sequential;
+        ASSERT_TRUE_MSG(same, "list::parallel_transform_reduce deterministic")
+        double expected = 0.5;
+        for (double x : values) {
+            expected += x * x;
+        }
+        ASSERT_TRUE_MSG(std::abs(sequential - expected) < 1e-6 * expected, "list::parallel_transform_reduce value")
+
+        // некоммутативная свертка сохраняет порядок элементов
+        task::list<std::string> digits;
+        std::string concatenated = ">";
+        for (size_t i = 0; i < 20000; ++i) {
+            digits.push_back(std::to_string(i % 10));
+            concatenated += digits.back();
+        }
+        ASSERT_TRUE_MSG(digits.parallel_transform_reduce(std::string(">"), std::plus<std::string>(),
+                                                         [](const std::string& s) { return s; }, 4) == concatenated,
+                        "list::parallel_transform_reduce order")
+        ASSERT_TRUE_MSG(task::list<int>().parallel_transform_reduce(7, std::plus<int>(), [](int x) { return x; }) == 7,
+                        "list::parallel_transform_reduce empty")
+    }
+
+    {
+        // количество обращений к аллокатору для каждой операции списка
+        using Alloc = task::counting_allocator<std::allocator<int>>;
+        using List = task::list<int, Alloc>;
+        task::allocation_stats stats;
+        size_t global_before = task::global_allocation_stats().allocations;
+        {
+            List list((Alloc(&stats)));
+            ASSERT_TRUE_MSG(stats.allocations == 0, "counting: empty list does not allocate")
+            AllocatorCalls calls = CountCalls(stats, [&] {
+                for (int i = 0; i < 100; ++i) {
+                    list.push_back(100 - i);
+                }
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 100 && calls.constructions == 100, "counting: push_back")
+            ASSERT_TRUE_MSG(task::global_allocation_stats().allocations - global_before == 100, "counting: global stats")
+            calls = CountCalls(stats, [&] {
+                list.emplace_front(7);
+                list.emplace(std::next(list.cbegin()), 8);
+                list.insert(list.cend(), 3, 9);
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 5 && calls.constructions == 5, "counting: emplace and insert")
+
+            // перестановки элементов не обращаются к аллокатору
+            List other((Alloc(&stats)));
+            other.push_back(1000);
+            calls = CountCalls(stats, [&] {
+                list.sort();
+                list.adaptive_sort();
+                list.radix_sort();
+                list.parallel_sort(size_t(4));
+                list.reverse();
+                list.sort();
+                list.merge(other);
+                other.splice(other.cend(), list, list.cbegin());
+                other.splice(other.cend(), list, list.cbegin(), std::next(list.cbegin(), 3));
+                list.splice(list.cend(), other);
+                std::swap(list, other);
+                std::swap(list, other);
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.deallocations == 0 && calls.constructions == 0,
+                            "counting: sort, merge, splice and swap do not allocate")
+
+            calls = CountCalls(stats, [&] { list.erase(list.cbegin()); });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.deallocations == 1 && calls.destructions == 1, "counting: erase")
+            size_t size = list.size();
+            calls = CountCalls(stats, [&] { list.unique(); });
+            size_t removed = size - list.size();
+            ASSERT_TRUE_MSG(removed == 5 && calls.deallocations == removed && calls.destructions == removed, "counting: unique")
+            calls = CountCalls(stats, [&] { list.remove(1000); });
+            ASSERT_TRUE_MSG(calls.deallocations == 1 && calls.destructions == 1, "counting: remove")
+
+            // копирование выделяет память только под недостающие элементы
+            calls = CountCalls(stats, [&] {
+                List copy(list);
+                ASSERT_TRUE_MSG(copy.get_allocator().stats() == &stats, "counting: copy shares stats")
+            });
+            ASSERT_TRUE_MSG(calls.allocations == list.size() && calls.deallocations == list.size(), "counting: copy")
+            List target((Alloc(&stats)));
+            target.insert(target.cend(), 10, 0);
+            calls = CountCalls(stats, [&] { target = list; });
+            ASSERT_TRUE_MSG(calls.allocations == list.size() - 10 && calls.constructions == list.size() - 10,
+                            "counting: copy assignment reuses elements")
+            calls = CountCalls(stats, [&] { target = list; });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.deallocations == 0, "counting: copy assignment of equal size")
+            calls = CountCalls(stats, [&] {
+                List moved(std::move(target));
+                target = std::move(moved);
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.deallocations == 0, "counting: move")
+
+            // compact: массив элементов, описание блока и ссылка на блок в списке
+            size = list.size();
+            calls = CountCalls(stats, [&] { list.compact(); });
+            ASSERT_TRUE_MSG(calls.allocations == 3 && calls.deallocations == size && calls.destructions == size,
+                            "counting: compact")
+            calls = CountCalls(stats, [&] { list.pop_back(); });
+            ASSERT_TRUE_MSG(calls.deallocations == 0 && calls.destructions == 1, "counting: pop_back of compacted element")
+
+            calls = CountCalls(stats, [&] { list.clear(); });
+            // оставшиеся size - 1 элементов и ссылка на блок; освобождаются только массив и описание блока
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.destructions == size && calls.deallocations == 2, "counting: clear")
+            ASSERT_TRUE_MSG(stats.peak_live_bytes >= stats.live_bytes, "counting: peak")
+        }
+        ASSERT_TRUE_MSG(stats.live_bytes == 0 && stats.allocations == stats.deallocations &&
+                        stats.constructions == stats.destructions, "counting: everything is released")
+    }
+
+    {
+        // forward_list: случайные операции в сравнении с std::forward_list
+        std::mt19937 gen(23);
+        task::forward_list<int> list_task;
+        std::forward_list<int> list_std;
+        auto check = [&](const char* msg) {
+            ASSERT_EQUAL_MSG(list_task, list_std, msg)
+            if (!list_std.empty()) {
+                ASSERT_TRUE_MSG(list_task.back() == *std::next(list_std.before_begin(),
+                                std::distance(list_std.begin(), list_std.end())), "forward_list::back")
+            }
+        };
+        for (int iter = 0; iter < 3000; ++iter) {
+            size_t size = std::distance(list_std.begin(), list_std.end());
+            size_t pos = gen() % (size + 1);
+            auto it_task = std::next(list_task.cbefore_begin(), pos);
+            auto it_std = std::next(list_std.cbefore_begin(), pos);
+            int value = gen() % 50;
+            switch (gen() % 8) {
+                case 0:
+                    list_task.insert_after(it_task, value);
+                    list_std.insert_after(it_std, value);
+                    break;
+                case 1:
+                    list_task.insert_after(it_task, 3, value);
+                    list_std.insert_after(it_std, 3, value);
+                    break;
+                case 2:
+                    list_task.emplace_after(it_task, value);
+                    list_std.emplace_after(it_std, value);
+                    break;
+                case 3:
+                    if (pos < size) {
+                        list_task.erase_after(it_task);
+                        list_std.erase_after(it_std);
+                    }
+                    break;
+                case 4: {
+                    size_t count = gen() % (size - pos + 1);
+                    list_task.erase_after(it_task, std::next(it_task, count + 1));
+                    list_std.erase_after(it_std, std::next(it_std, count + 1));
+                    break;
+                }
+                case 5:
+                    list_task.push_front(value);
+                    list_std.push_front(value);
+                    break;
+                case 6:
+                    if (size > 0) {
+                        list_task.pop_front();
+                        list_std.pop_front();
+                    }
+                    break;
+                case 7:
+                    list_task.push_back(value);
+                    list_std.insert_after(std::next(list_std.before_begin(), size), value);
+                    break;
+            }
+            check("forward_list: random operations");
+        }
+
+        list_task.sort();
+        list_std.sort();
+        check("forward_list::sort");
+        task::forward_list<int> other_task = {5, 10, 49, 100};
+        std::forward_list<int> other_std = {5, 10, 49, 100};
+        list_task.merge(other_task);
+        list_std.merge(other_std);
+        ASSERT_TRUE_MSG(other_task.empty(), "forward_list::merge empties other")
+        task::forward_list<int> empty_task, merged_task = {1, 2, 3};
+        empty_task.merge(merged_task);
+        ASSERT_TRUE_MSG(empty_task.back() == 3 && merged_task.empty(), "forward_list::merge into empty list")
+        empty_task.push_back(9);
+        std::vector<int> merged_expected = {1, 2, 3, 9};
+        ASSERT_EQUAL_MSG(empty_task, merged_expected, "forward_list: push_back after merge into empty list")
+        check("forward_list::merge");
+        ASSERT_TRUE_MSG(list_task.unique() > 0, "forward_list::unique count")
+        list_std.unique();
+        check("forward_list::unique");
+        list_task.remove_if([](int x) { return x % 3 == 0; });
+        list_std.remove_if([](int x) { return x % 3 == 0; });
+        check("forward_list::remove_if");
+
+        // исключение из предиката: уже исключенные элементы удаляются, хвост остается верным
+        task::forward_list<int> throwing_list = {0, 1, 2, 3, 4, 5, 6, 7};
+        int removal_calls = 0;
+        bool removal_thrown = false;
+        try {
+            throwing_list.remove_if([&removal_calls](int x) {
+                if (++removal_calls == 5) {
+                    throw std::runtime_error("predicate");
+                }
+                return x % 2 == 0;
+            });
+        }
+        catch (const std::runtime_error&) {
+            removal_thrown = true;
+        }
+        throwing_list.push_back(8);
+        std::vector<int> throwing_expected = {1, 3, 4, 5, 6, 7, 8};
+        ASSERT_TRUE_MSG(removal_thrown, "forward_list::remove_if rethrows")
+        ASSERT_EQUAL_MSG(throwing_list, throwing_expected, "forward_list::remove_if after exception")
+        throwing_list = {1, 1, 2, 2, 3, 3};
+        removal_calls = 0;
+        removal_thrown = false;
+        try {
+            throwing_list.unique([&removal_calls](int a, int b) {
+                if (++removal_calls == 3) {
+                    throw std::runtime_error("predicate");
+                }
+                return a == b;
+            });
+        }
+        catch (const std::runtime_error&) {
+            removal_thrown = true;
+        }
+        throwing_list.push_back(4);
+        throwing_expected = {1, 2, 2, 3, 3, 4};
+        ASSERT_TRUE_MSG(removal_thrown, "forward_list::unique rethrows")
+        ASSERT_EQUAL_MSG(throwing_list, throwing_expected, "forward_list::unique after exception")
+        list_task.reverse();
+        list_std.reverse();
+        check("forward_list::reverse");
+        list_task.sort(std::greater<int>());
+        list_std.sort(std::greater<int>());
+        check("forward_list::sort with comparator");
+
+        // устойчивость сортировки
+        task::forward_list<std::pair<int, int>> pairs;
+        for (int i = 0; i < 1000; ++i) {
+            pairs.push_back({static_cast<int>(gen() % 10), i});
+        }
+        pairs.sort([](const auto& a, const auto& b) { return a.first < b.first; });
+        ASSERT_TRUE_MSG(std::is_sorted(pairs.begin(), pairs.end()), "forward_list::sort is stable")
+
+        // исключение из компаратора: элементы остаются в списке, back() указывает на последний
+        size_t comparisons_left = 500;
+        bool thrown = false;
+        try {
+            pairs.sort([&comparisons_left](const auto& a, const auto& b) {
+                if (--comparisons_left == 0) {
+                    throw std::runtime_error("compare");
+                }
+                return a.second > b.second;
+            });
+        }
+        catch (const std::runtime_error&) {
+            thrown = true;
+        }
+        pairs.push_back({-1, -1});
+        ASSERT_TRUE_MSG(thrown && std::distance(pairs.begin(), pairs.end()) == 1001 && pairs.back().first == -1,
+                        "forward_list::sort keeps elements on exception")
+
+        // splice_after: весь список, один элемент, диапазон
+        task::forward_list<int> a = {1, 2, 3}, b = {4, 5, 6, 7};
+        a.splice_after(a.cbefore_begin(), b, b.cbefore_begin());
+        ASSERT_TRUE_MSG(a.front() == 4 && b.front() == 5, "forward_list::splice_after element")
+        a.splice_after(std::next(a.cbegin(), 3), b, b.cbegin(), b.cend());
+        std::vector<int> expected = {4, 1, 2, 3, 6, 7};
+        ASSERT_EQUAL_MSG(a, expected, "forward_list::splice_after range")
+        ASSERT_TRUE_MSG(b.front() == 5 && b.back() == 5, "forward_list::splice_after range leaves the rest")
+        a.splice_after(std::next(a.cbegin(), 5), b);
+        ASSERT_TRUE_MSG(a.back() == 5 && b.empty(), "forward_list::splice_after list")
+        b.push_back(8);
+        ASSERT_TRUE_MSG(b.front() == 8 && b.back() == 8, "forward_list: push_back after splice")
+        a.splice_after(a.cbefore_begin(), a, std::next(a.cbegin(), 5));
+        ASSERT_TRUE_MSG(a.front() == 5 && a.back() == 7, "forward_list::splice_after own last element")
+    }
+
+    {
+        // forward_list: аллокаторы, как у task::list
+        using Propagating = TaggedAllocator<int, true>;
+        using Sticky = TaggedAllocator<int, false>;
+        tag_mismatches = 0;
+        {
+            task::forward_list<int, Propagating> a({1, 2, 3}, Propagating(1)), b({4, 5}, Propagating(2));
+            task::forward_list<int, Propagating> copy(a);
+            ASSERT_TRUE_MSG(copy.get_allocator().id == 1, "forward_list: select_on_container_copy_construction")
+            b = a;
+            ASSERT_TRUE_MSG(b.get_allocator().id == 1 && b.back() == 3, "forward_list: propagate_on_container_copy_assignment")
+            b = task::forward_list<int, Propagating>(3, 7, Propagating(3));
+            ASSERT_TRUE_MSG(b.get_allocator().id == 3 && b.back() == 7, "forward_list: propagate_on_container_move_assignment")
+            a.swap(b);
+            ASSERT_TRUE_MSG(a.get_allocator().id == 3 && b.get_allocator().id == 1 && b.back() == 3,
+                            "forward_list: propagate_on_container_swap")
+        }
+        {
+            task::forward_list<int, Sticky> a({1, 2, 3}, Sticky(1)), b({4, 5, 6, 7}, Sticky(2));
+            task::forward_list<int, Sticky> copy(a);
+            ASSERT_TRUE_MSG(copy.get_allocator().id == -1, "forward_list: copy without propagation")
+            b = a;
+            ASSERT_TRUE_MSG(b.get_allocator().id == 2 && b.back() == 3, "forward_list: copy assignment keeps allocator")
+            b = std::move(copy);
+            ASSERT_TRUE_MSG(b.get_allocator().id == 2 && b.front() == 1 && b.back() == 3,
+                            "forward_list: move assignment with unequal allocators")
+            task::forward_list<int, Sticky> moved(std::move(a), Sticky(4));
+            ASSERT_TRUE_MSG(moved.get_allocator().id == 4 && moved.back() == 3, "forward_list: move with another allocator")
+            task::forward_list<int, Sticky> same(std::move(moved), Sticky(4));
+            ASSERT_TRUE_MSG(same.back() == 3 && moved.empty(), "forward_list: move with equal allocator")
+            moved.push_back(1);
+            ASSERT_TRUE_MSG(moved.front() == 1, "forward_list: moved-from list is usable")
+        }
+        ASSERT_TRUE_MSG(tag_mismatches == 0, "forward_list: memory is freed by the allocator it came from")
+
+        char buffer[1 << 14];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+        task::pmr::forward_list<std::pmr::string> strings(&arena);
+        strings.emplace_back("a string long enough to skip the small buffer optimization");
+        strings.emplace_front("another string long enough to skip the small buffer optimization");
+        ASSERT_TRUE_MSG(strings.back().get_allocator().resource() == &arena, "forward_list: pmr elements use the list resource")
+
+        // сортировка, слияние и перенос не обращаются к аллокатору
+        using Alloc = task::counting_allocator<std::allocator<int>>;
+        task::allocation_stats stats;
+        {
+            task::forward_list<int, Alloc> list((Alloc(&stats))), other((Alloc(&stats)));
+            for (int i = 0; i < 100; ++i) {
+                list.push_front(i * 37 % 101);
+            }
+            other.push_back(1000);
+            AllocatorCalls calls = CountCalls(stats, [&] {
+                list.sort();
+                list.merge(other);
+                list.reverse();
+                other.splice_after(other.cbefore_begin(), list, list.cbefore_begin());
+                list.splice_after(list.cbefore_begin(), other);
+                list.sort(std::greater<int>());
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.deallocations == 0, "forward_list: sort, merge and splice do not allocate")
+            calls = CountCalls(stats, [&] { list.erase_after(list.cbegin(), list.cend()); });
+            ASSERT_TRUE_MSG(calls.deallocations == 100 && calls.destructions == 100, "forward_list: erase_after range")
+        }
+        ASSERT_TRUE_MSG(stats.live_bytes == 0, "forward_list: everything is released")
+    }
+
+    {
+        // small_list: случайные операции над двумя списками в сравнении с std::list
+        std::mt19937 gen(24);
+        task::small_list<std::string, 4> lists_task[2];
+        std::list<std::string> lists_std[2];
+        for (int iter = 0; iter < 4000; ++iter) {
+            size_t i = gen() % 2, j = gen() % 2;
+            auto& list_task = lists_task[i];
+            auto& list_std = lists_std[i];
+            size_t pos = gen() % (list_std.size() + 1);
+            auto it_task = std::next(list_task.cbegin(), pos);
+            auto it_std = std::next(list_std.cbegin(), pos);
+            std::string value = std::to_string(gen() % 20);
+            switch (gen() % 9) {
+                case 0:
+                    list_task.insert(it_task, value);
+                    list_std.insert(it_std, value);
+                    break;
+                case 1:
+                    list_task.emplace_back(value);
+                    list_std.emplace_back(value);
+                    break;
+                case 2:
+                    list_task.push_front(value);
+                    list_std.push_front(value);
+                    break;
+                case 3:
+                case 4:
+                    if (pos < list_std.size()) {
+                        list_task.erase(it_task);
+                        list_std.erase(it_std);
+                    }
+                    break;
+                case 5:
+                    if (!lists_std[j].empty()) {
+                        size_t from = gen() % lists_std[j].size();
+                        auto from_std = std::next(lists_std[j].cbegin(), from);
+                        auto spliced = list_task.splice(it_task, lists_task[j], std::next(lists_task[j].cbegin(), from));
+                        ASSERT_TRUE_MSG(*spliced == *from_std, "small_list::splice returns the moved element")
+                        list_std.splice(it_std, lists_std[j], from_std);
+                    }
+                    break;
+                case 6:
+                    if (i != j) {
+                        size_t from = gen() % (lists_std[j].size() + 1);
+                        size_t to = from + gen() % (lists_std[j].size() - from + 1);
+                        list_task.splice(it_task, lists_task[j], std::next(lists_task[j].cbegin(), from),
+                                         std::next(lists_task[j].cbegin(), to));
+                        list_std.splice(it_std, lists_std[j], std::next(lists_std[j].cbegin(), from),
+                                        std::next(lists_std[j].cbegin(), to));
+                    }
+                    break;
+                case 7:
+                    if (i != j && gen() % 8 == 0) {
+                        list_task.splice(it_task, lists_task[j]);
+                        list_std.splice(it_std, lists_std[j]);
+                    }
+                    break;
+                case 8:
+                    if (gen() % 16 == 0) {
+                        lists_task[0].swap(lists_task[1]);
+                        lists_std[0].swap(lists_std[1]);
+                    }
+                    break;
+            }
+            for (size_t k = 0; k < 2; ++k) {
+                ASSERT_EQUAL_MSG(lists_task[k], lists_std[k], "small_list: random operations")
+                ASSERT_TRUE_MSG(lists_task[k].size() == lists_std[k].size(), "small_list::size")
+            }
+        }
+        for (size_t k = 0; k < 2; ++k) {
+            lists_task[k].sort();
+            lists_std[k].sort();
+        }
+        lists_task[0].merge(lists_task[1]);
+        lists_std[0].merge(lists_std[1]);
+        ASSERT_EQUAL_MSG(lists_task[0], lists_std[0], "small_list::merge")
+        ASSERT_TRUE_MSG(lists_task[1].empty() && lists_task[0].size() == lists_std[0].size(), "small_list::merge sizes")
+        lists_task[0].unique();
+        lists_std[0].unique();
+        lists_task[0].reverse();
+        lists_std[0].reverse();
+        ASSERT_EQUAL_MSG(lists_task[0], lists_std[0], "small_list::unique and reverse")
+        ASSERT_TRUE_MSG(std::equal(lists_task[0].rbegin(), lists_task[0].rend(), lists_std[0].rbegin()), "small_list: reverse iteration")
+
+        // перемещение и копирование
+        task::small_list<std::string, 4> moved(std::move(lists_task[0]));
+        ASSERT_EQUAL_MSG(moved, lists_std[0], "small_list: move construction")
+        ASSERT_TRUE_MSG(lists_task[0].empty(), "small_list: moved-from list is empty")
+        lists_task[0] = moved;
+        lists_task[1] = std::move(moved);
+        ASSERT_EQUAL_MSG(lists_task[0], lists_std[0], "small_list: copy assignment")
+        ASSERT_EQUAL_MSG(lists_task[1], lists_std[0], "small_list: move assignment")
+    }
+
+    {
+        // small_list: первые N элементов не обращаются к аллокатору
+        using Alloc = task::counting_allocator<std::allocator<int>>;
+        using List = task::small_list<int, 8, Alloc>;
+        task::allocation_stats stats;
+        {
+            List list((Alloc(&stats)));
+            AllocatorCalls calls = CountCalls(stats, [&] {
+                for (int i = 0; i < 8; ++i) {
+                    list.push_back(i);
+                }
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.constructions == 8, "small_list: inline elements")
+            ASSERT_TRUE_MSG(list.is_inline(list.cbegin()) && list.is_inline(std::prev(list.cend())), "small_list::is_inline")
+            calls = CountCalls(stats, [&] { list.push_back(8); });
+            ASSERT_TRUE_MSG(calls.allocations == 1 && !list.is_inline(std::prev(list.cend())), "small_list: fallback to allocator")
+
+            // место удаленного встроенного элемента используется повторно; остальные итераторы не меняются
+            auto third = std::next(list.cbegin(), 2);
+            auto last = std::prev(list.cend());
+            calls = CountCalls(stats, [&] {
+                list.erase(list.cbegin());
+                list.push_front(-1);
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.deallocations == 0, "small_list: inline place is reused")
+            ASSERT_TRUE_MSG(*third == 2 && *last == 8, "small_list: iterators stay valid")
+
+            calls = CountCalls(stats, [&] {
+                list.sort(std::greater<int>());
+                list.reverse();
+                list.splice(list.cend(), list, list.cbegin());
+            });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.constructions == 0, "small_list: sort and splice within a list")
+
+            // из другого списка встроенные элементы копируются, остальные переносятся указателями
+            List other((Alloc(&stats)));
+            for (int i = 100; i < 110; ++i) {
+                other.push_back(i);
+            }
+            List target((Alloc(&stats)));
+            auto heap_element = std::prev(other.cend());
+            calls = CountCalls(stats, [&] { target.splice(target.cend(), other); });
+            ASSERT_TRUE_MSG(calls.allocations == 0 && calls.constructions == 8 && calls.destructions == 8,
+                            "small_list: splice copies out inline elements only")
+            ASSERT_TRUE_MSG(other.empty() && target.size() == 10 && &*std::prev(target.cend()) == &*heap_element,
+                            "small_list: heap elements are relinked")
+            ASSERT_TRUE_MSG(target.front() == 100 && target.is_inline(target.cbegin()), "small_list: copied elements are inline")
+        }
+        ASSERT_TRUE_MSG(stats.live_bytes == 0 && stats.constructions == stats.destructions, "small_list: everything is released")
+    }
+
     {
         const size_t LIST_COUNT = 5;
         const size_t ITER_COUNT = 4000;
@@ -0,0 +1,6 @@
+#!/bin/bash
+
+set -e
+
+g++ -std=c++17 -O2 -pthread -I./ bench/bench.cpp -o smart_pointers_bench
+./smart_pointers_bench "$@"
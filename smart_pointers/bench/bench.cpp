@@ -0,0 +1,97 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "src/smart_pointers.h"
+
+
+struct Measurement {
+    double ms; // время выполнения
+    double mops; // миллионов операций в секунду на все потоки
+};
+
+// каждый из threads потоков выполняет op n раз над общими указателями
+template <class Op>
+Measurement MeasureThreads(size_t n, size_t threads, Op op) {
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (size_t t = 0; t < threads; ++t) {
+        workers.emplace_back([n, &op] {
+            for (size_t i = 0; i < n; ++i) {
+                op();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    auto finish = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(finish - start).count();
+    return {ms, double(n * threads) / ms / 1000};
+}
+
+void Report(const std::string& name, size_t n, size_t threads, Measurement task_m, Measurement std_m) {
+    std::cout << std::left << std::setw(24) << name << " n=" << std::setw(10) << n << " threads=" << std::setw(3) << threads
+              << std::right << std::fixed << std::setprecision(2)
+              << " task: " << std::setw(10) << task_m.ms << " ms " << std::setw(8) << task_m.mops << " Mops/s"
+              << " | std: " << std::setw(10) << std_m.ms << " ms " << std::setw(8) << std_m.mops << " Mops/s"
+              << std::endl;
+}
+
+
+// копирование и уничтожение общего указателя: два изменения счетчика на операцию
+template <class Shared>
+Measurement MeasureCopy(size_t n, size_t threads) {
+    Shared shared(new long(1));
+    return MeasureThreads(n, threads, [&shared] {
+        Shared copy(shared);
+        static_cast<void>(copy);
+    });
+}
+
+// lock из WeakPtr: CAS-увеличение и уменьшение счетчика
+template <class Shared, class Weak>
+Measurement MeasureLock(size_t n, size_t threads) {
+    Shared shared(new long(1));
+    Weak weak(shared);
+    return MeasureThreads(n, threads, [&weak] {
+        Shared locked = weak.lock();
+        static_cast<void>(locked);
+    });
+}
+
+void BenchSingleThreaded(size_t n) {
+    // цена атомарных счетчиков без конкуренции: в колонке task - SingleThreaded, в колонке std - MultiThreaded
+    using Single = task::SharedPtr<long, task::SingleThreaded>;
+    using Multi = task::SharedPtr<long, task::MultiThreaded>;
+    Report("copy/single vs multi", n, 1, MeasureCopy<Single>(n, 1), MeasureCopy<Multi>(n, 1));
+    Report("lock/single vs multi", n, 1,
+           MeasureLock<Single, task::WeakPtr<long, task::SingleThreaded>>(n, 1),
+           MeasureLock<Multi, task::WeakPtr<long, task::MultiThreaded>>(n, 1));
+}
+
+void BenchMultiThreaded(size_t n) {
+    // MultiThreaded против std::shared_ptr при одновременной работе с одним счетчиком
+    using Shared = task::SharedPtr<long, task::MultiThreaded>;
+    using Weak = task::WeakPtr<long, task::MultiThreaded>;
+    size_t max_threads = std::max<size_t>(std::thread::hardware_concurrency(), 2);
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        Report("copy/multi", n, threads,
+               MeasureCopy<Shared>(n, threads), MeasureCopy<std::shared_ptr<long>>(n, threads));
+        Report("lock/multi", n, threads,
+               MeasureLock<Shared, Weak>(n, threads), MeasureLock<std::shared_ptr<long>, std::weak_ptr<long>>(n, threads));
+    }
+}
+
+
+int main(int argc, char* argv[]) {
+    size_t n = (argc > 1) ? std::strtoull(argv[1], nullptr, 10) : 10000000;
+
+    BenchSingleThreaded(n);
+    BenchMultiThreaded(n);
+}
@@ -1,6 +1,8 @@
 #ifndef smart_pointers_h
 #define smart_pointers_h
 
+#include <atomic>
+
 namespace task {
     
     template<class T>
@@ -34,41 +36,96 @@ namespace task {
         pointer ptr;
     };
     
+    // политики потоков для счетчиков SharedPtr и WeakPtr
+    // SingleThreaded - обычные счетчики: быстрее всего, но все указатели на объект
+    // должны использоваться из одного потока
+    struct SingleThreaded {
+        using count_type = long;
+        static void increment(count_type& c) {
+            ++c;
+        }
+        static long decrement(count_type& c) { // возвращает новое значение
+            return --c;
+        }
+        static long load(const count_type& c) {
+            return c;
+        }
+        static bool incrementIfNonZero(count_type& c) {
+            if (c == 0) {
+                return false;
+            }
+            ++c;
+            return true;
+        }
+    };
+
+    // MultiThreaded - атомарные счетчики: указатели на один объект можно копировать и
+    // уничтожать из разных потоков. Увеличение relaxed (тот, кто копирует, уже владеет ссылкой),
+    // уменьшение acq_rel: изменения объекта в любом потоке видны потоку, который его удаляет
+    struct MultiThreaded {
+        using count_type = std::atomic<long>;
+        static void increment(count_type& c) {
+            c.fetch_add(1, std::memory_order_relaxed);
+        }
+        static long decrement(count_type& c) {
+            return c.fetch_sub(1, std::memory_order_acq_rel) - 1;
+        }
+        static long load(const count_type& c) {
+            return c.load(std::memory_order_acquire);
+        }
+        static bool incrementIfNonZero(count_type& c) {
+            // счетчик, однажды ставший нулем, больше не растет: объект уже удаляется
+            long value = c.load(std::memory_order_relaxed);
+            while (value != 0) {
+                if (c.compare_exchange_weak(value, value + 1, std::memory_order_acq_rel, std::memory_order_relaxed)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    };
+
     // вспомогательный класс счетчик для shared и weak ptr
+    // создается вместе с первым SharedPtr, поэтому оба счетчика начинаются с 1
+    template<class Policy = SingleThreaded>
     class Counter {
     private:
-        long count; // счетчик SharedPtr
-        long weak_count; // счетчик WeakPtr (+1 если count != 0)
+        using count_type = typename Policy::count_type;
+        count_type count; // счетчик SharedPtr
+        count_type weak_count; // счетчик WeakPtr (+1 если count != 0)
     public:
-        void add() { // увеличение shared
-            if (count++ == 0) {
-                weak_count++;
-            }
+        Counter() : count(1), weak_count(1) {
+        }
+        void add() { // увеличение shared, вызывающий уже владеет ссылкой
+            Policy::increment(count);
+        }
+        bool addIfNonZero() { // увеличение shared, если объект еще жив (для WeakPtr::lock)
+            return Policy::incrementIfNonZero(count);
         }
         void addWeak() { // увелиение weak
-            weak_count++;
+            Policy::increment(weak_count);
         }
-        long release() { // уменьшение shared
-            if (--count == 0) {
-                weak_count--;
-            }
-            return count;
+        // уменьшение shared; при 0 владелец удаляет объект, а затем снимает
+        // общую weak-ссылку всех SharedPtr через releaseWeak
+        long release() {
+            return Policy::decrement(count);
         }
         long releaseWeak() { // уменьшение weak
-            return --weak_count;
+            return Policy::decrement(weak_count);
         }
-        long getCount() {
-            return count;
+        long getCount() const {
+            return Policy::load(count);
         }
-        long getWeakCount() {
-            return weak_count;
+        long getWeakCount() const {
+            return Policy::load(weak_count);
         }
     };
     
-    template<class T>
+    template<class T, class Policy = SingleThreaded>
     class WeakPtr;
     
-    template<class T>
+    // Policy - политика потоков для счетчика ссылок: SingleThreaded или MultiThreaded
+    template<class T, class Policy = SingleThreaded>
     class SharedPtr {
     public:
         using pointer = T*;
@@ -78,7 +135,7 @@ namespace task {
         SharedPtr(pointer p = nullptr); // из обычного указателя
         SharedPtr(const SharedPtr& u); // копирования
         SharedPtr(SharedPtr&& u); // перемещения
-        SharedPtr(const WeakPtr<T>& w); // из WeakPtr
+        SharedPtr(const WeakPtr<T, Policy>& w); // из WeakPtr
         
         SharedPtr& operator=(const SharedPtr& u); // копирующий оператор присваивания
         SharedPtr& operator=(SharedPtr&& u); // перемещающий оператор присваивания
@@ -95,13 +152,13 @@ namespace task {
         void reset(pointer p = pointer());
         void swap(SharedPtr& other);
         
-        friend WeakPtr<T>;
+        friend WeakPtr<T, Policy>;
     private:
         pointer ptr;
-        Counter *counter;
+        Counter<Policy> *counter;
     };
   
-    template<class T>
+    template<class T, class Policy>
     class WeakPtr {
     public:
         using pointer = T*;
@@ -109,12 +166,12 @@ namespace task {
         
         // конструкторы
         WeakPtr(); // по умолчанию
-        WeakPtr(const SharedPtr<T>& u); // из SharedPtr
+        WeakPtr(const SharedPtr<T, Policy>& u); // из SharedPtr
         WeakPtr(const WeakPtr& u); // копирования
         WeakPtr(WeakPtr&& u); // перемещения
         
         WeakPtr& operator=(const WeakPtr& u); // копирующий оператор присваивания
-        WeakPtr& operator=(const SharedPtr<T>& u); // оператор присваивания SharedPtr
+        WeakPtr& operator=(const SharedPtr<T, Policy>& u); // оператор присваивания SharedPtr
         WeakPtr& operator=(WeakPtr&& u); // перемещающий оператор присваивания
         
         // деструктор
@@ -123,15 +180,17 @@ namespace task {
         bool expired() const;
         long use_count() const;
         
-        SharedPtr<T> lock(); // получение SharedPtr
+        // получение SharedPtr; пустой, если объект уже удален. Счетчик увеличивается, только если
+        // он не равен нулю, поэтому lock безопасен при одновременном удалении последнего SharedPtr
+        SharedPtr<T, Policy> lock() const;
         
         void reset();
         void swap(WeakPtr& other);
         
-        friend SharedPtr<T>;
+        friend SharedPtr<T, Policy>;
     private:
         pointer ptr;
-        Counter *counter;
+        Counter<Policy> *counter;
     };
     
     // UniquePtr
@@ -199,48 +258,43 @@ namespace task {
     // SharedPtr
     
     // конструкторы
-    template<class T>
-    SharedPtr<T>::SharedPtr(pointer p) : ptr(p) {
-        // создаем и увеличиваем счетчик
+    template<class T, class Policy>
+    SharedPtr<T, Policy>::SharedPtr(pointer p) : ptr(p) {
+        // создаем счетчик, он уже учитывает этот SharedPtr
         if (p != nullptr) {
-            counter = new Counter();
-            counter->add();
+            counter = new Counter<Policy>();
         }
         else {
             counter = nullptr;
         }
     }
     
-    template<class T>
-    SharedPtr<T>::SharedPtr(SharedPtr<T>&& sp) : ptr(sp.ptr), counter(sp.counter) {
+    template<class T, class Policy>
+    SharedPtr<T, Policy>::SharedPtr(SharedPtr<T, Policy>&& sp) : ptr(sp.ptr), counter(sp.counter) {
         sp.ptr = nullptr;
         sp.counter = nullptr;
     }
     
-    template<class T>
-    SharedPtr<T>::SharedPtr(const SharedPtr<T>& sp) : ptr(sp.ptr), counter(sp.counter) {
+    template<class T, class Policy>
+    SharedPtr<T, Policy>::SharedPtr(const SharedPtr<T, Policy>& sp) : ptr(sp.ptr), counter(sp.counter) {
         // увеличиваем счетчик при создании нового SharedPtr
         if (counter != nullptr)
             counter->add();
     }
     
-    template<class T>
-    SharedPtr<T>::SharedPtr(const WeakPtr<T>& wp) {
-        if (wp.use_count() == 0) {
-            counter = nullptr;
-            ptr = nullptr;
-        }
-        else {
+    template<class T, class Policy>
+    SharedPtr<T, Policy>::SharedPtr(const WeakPtr<T, Policy>& wp) : ptr(nullptr), counter(nullptr) {
+        // проверка и увеличение счетчика - одна операция: объект не может быть удален между ними
+        if (wp.counter && wp.counter->addIfNonZero()) {
             counter = wp.counter;
-            counter->add();
             ptr = wp.ptr;
         }
     }
     
     // операторы присваивания
     
-    template<class T>
-    SharedPtr<T>& SharedPtr<T>::operator=(SharedPtr<T>&& sp) {
+    template<class T, class Policy>
+    SharedPtr<T, Policy>& SharedPtr<T, Policy>::operator=(SharedPtr<T, Policy>&& sp) {
         reset(nullptr); // удаляем текущий указатель, если он есть
         ptr = sp.ptr;
         counter = sp.counter;
@@ -249,8 +303,11 @@ namespace task {
         return *this;
     }
     
-    template<class T>
-    SharedPtr<T>& SharedPtr<T>::operator=(const SharedPtr<T>& sp) {
+    template<class T, class Policy>
+    SharedPtr<T, Policy>& SharedPtr<T, Policy>::operator=(const SharedPtr<T, Policy>& sp) {
+        if (this == &sp) {
+            return *this;
+        }
         reset(nullptr); // удаляем текущий указатель, если он есть
         counter = sp.counter;
         ptr = sp.ptr;
@@ -261,28 +318,28 @@ namespace task {
     }
     
     // декструктор
-    template<class T>
-    SharedPtr<T>::~SharedPtr() {
+    template<class T, class Policy>
+    SharedPtr<T, Policy>::~SharedPtr() {
         reset(nullptr); // уменьшаем счетчики и освобождаем память, если нужно
     }
     
-    template<class T>
-    typename SharedPtr<T>::pointer SharedPtr<T>::operator->() const {
+    template<class T, class Policy>
+    typename SharedPtr<T, Policy>::pointer SharedPtr<T, Policy>::operator->() const {
         return ptr;
     }
     
-    template<class T>
-    T& SharedPtr<T>::operator*() const {
+    template<class T, class Policy>
+    T& SharedPtr<T, Policy>::operator*() const {
         return *ptr;
     }
     
-    template<class T>
-    typename SharedPtr<T>::pointer SharedPtr<T>::get() const {
+    template<class T, class Policy>
+    typename SharedPtr<T, Policy>::pointer SharedPtr<T, Policy>::get() const {
         return ptr;
     }
     
-    template<class T>
-    long SharedPtr<T>::use_count() const {
+    template<class T, class Policy>
+    long SharedPtr<T, Policy>::use_count() const {
         // возвращаем 0, если указатель нулевой
         if (counter)
             return counter->getCount();
@@ -290,30 +347,29 @@ namespace task {
             return 0;
     }
     
-    template<class T>
-    void SharedPtr<T>::reset(pointer p) {
+    template<class T, class Policy>
+    void SharedPtr<T, Policy>::reset(pointer p) {
         // если счетчик = 0, освобождаем память
         if (counter && counter->release() == 0) {
             delete ptr;
-            // сам счетчик удаляем, если нет и WeakPtr
-            if (counter->getWeakCount() == 0) {
+            // снимаем weak-ссылку всех SharedPtr; сам счетчик удаляем, если нет и WeakPtr
+            if (counter->releaseWeak() == 0) {
                 delete counter;
             }
         }
         ptr = p;
         if (p != nullptr) {
-            counter = new Counter();
-            counter->add();
+            counter = new Counter<Policy>();
         }
         else {
             counter = nullptr;
         }
     }
     
-    template<class T>
-    void SharedPtr<T>::swap(SharedPtr& other) {
+    template<class T, class Policy>
+    void SharedPtr<T, Policy>::swap(SharedPtr& other) {
         pointer t = other.ptr;
-        Counter *c = other.counter;
+        Counter<Policy> *c = other.counter;
         other.ptr = ptr;
         other.counter = counter;
         ptr = t;
@@ -324,26 +380,26 @@ namespace task {
     
     // конструкторы
     
-    template<class T>
-    WeakPtr<T>::WeakPtr() : ptr(nullptr), counter(nullptr) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>::WeakPtr() : ptr(nullptr), counter(nullptr) {
         
     }
     
-    template<class T>
-    WeakPtr<T>::WeakPtr(const SharedPtr<T>& wp) : ptr(wp.ptr), counter(wp.counter) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>::WeakPtr(const SharedPtr<T, Policy>& wp) : ptr(wp.ptr), counter(wp.counter) {
         // при создании WeakPtr увеличиваем соответствующий счетчик
         if (counter)
             counter->addWeak();
     }
     
-    template<class T>
-    WeakPtr<T>::WeakPtr(WeakPtr<T>&& wp) : ptr(wp.ptr), counter(wp.counter) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>::WeakPtr(WeakPtr<T, Policy>&& wp) : ptr(wp.ptr), counter(wp.counter) {
         wp.ptr = nullptr;
         wp.counter = nullptr;
     }
     
-    template<class T>
-    WeakPtr<T>::WeakPtr(const WeakPtr<T>& wp) : ptr(wp.ptr), counter(wp.counter) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>::WeakPtr(const WeakPtr<T, Policy>& wp) : ptr(wp.ptr), counter(wp.counter) {
         // при создании копии увеличиваем соответствующий счетчик
         if (counter)
             counter->addWeak();
@@ -351,8 +407,12 @@ namespace task {
     
     // операторы присваивания
     
-    template<class T>
-    WeakPtr<T>& WeakPtr<T>::operator=(WeakPtr<T>&& wp) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>& WeakPtr<T, Policy>::operator=(WeakPtr<T, Policy>&& wp) {
+        if (this == &wp) {
+            return *this;
+        }
+        reset();
         ptr = wp.ptr;
         counter = wp.counter;
         wp.ptr = nullptr;
@@ -360,58 +420,61 @@ namespace task {
         return *this;
     }
     
-    template<class T>
-    WeakPtr<T>& WeakPtr<T>::operator=(const SharedPtr<T>& sp) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>& WeakPtr<T, Policy>::operator=(const SharedPtr<T, Policy>& sp) {
+        // счетчик объекта sp сначала увеличиваем, затем освобождаем текущий: это может быть один счетчик
+        if (sp.counter)
+            sp.counter->addWeak();
+        reset();
         counter = sp.counter;
         ptr = sp.ptr;
-        if (counter)
-            counter->addWeak();
         return *this;
     }
-    template<class T>
-    WeakPtr<T>& WeakPtr<T>::operator=(const WeakPtr<T>& u) {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>& WeakPtr<T, Policy>::operator=(const WeakPtr<T, Policy>& u) {
+        // при создании WeakPtr увеличиваем соответствующий счетчик (до освобождения текущего,
+        // иначе присваивание самому себе удалило бы счетчик)
+        if (u.counter)
+            u.counter->addWeak();
         // при необходимости удаляем счетчик текущего объекта
         if (counter && counter->releaseWeak() == 0) {
             delete counter;
         }
         counter = u.counter;
         ptr = u.ptr;
-        // при создании WeakPtr увеличиваем соответствующий счетчик
-        if (counter)
-            counter->addWeak();
         return *this;
     }
     
     // деструтор
-    template<class T>
-    WeakPtr<T>::~WeakPtr() {
+    template<class T, class Policy>
+    WeakPtr<T, Policy>::~WeakPtr() {
         if (counter && counter->releaseWeak() == 0) {
             delete counter;
         }
     }
     
-    template<class T>
-    bool WeakPtr<T>::expired() const {
+    template<class T, class Policy>
+    bool WeakPtr<T, Policy>::expired() const {
         return use_count() == 0;
     }
     
-    template<class T>
-    long WeakPtr<T>::use_count() const {
+    template<class T, class Policy>
+    long WeakPtr<T, Policy>::use_count() const {
         if (counter)
             return counter->getCount();
         else
             return 0;
     }
     
-    template<class T>
-    SharedPtr<T> WeakPtr<T>::lock() {
-        // создаем и возвращаем SharedPtr
-        SharedPtr<T> shared(*this);
+    template<class T, class Policy>
+    SharedPtr<T, Policy> WeakPtr<T, Policy>::lock() const {
+        // создаем и возвращаем SharedPtr (конструктор из WeakPtr увеличивает счетчик через CAS)
+        SharedPtr<T, Policy> shared(*this);
         return shared;
     }
     
-    template<class T>
-    void WeakPtr<T>::reset() {
+    template<class T, class Policy>
+    void WeakPtr<T, Policy>::reset() {
         // при необходимости удаляем счетчик текущего объекта
         if (counter && counter->releaseWeak() == 0) {
             delete counter;
@@ -420,10 +483,10 @@ namespace task {
         counter = nullptr;
     }
     
-    template<class T>
-    void WeakPtr<T>::swap(WeakPtr& other) {
+    template<class T, class Policy>
+    void WeakPtr<T, Policy>::swap(WeakPtr& other) {
         pointer t = other.ptr;
-        Counter *c = other.counter;
+        Counter<Policy> *c = other.counter;
         other.ptr = ptr;
         other.counter = counter;
         ptr = t;
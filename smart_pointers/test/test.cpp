@@ -3,11 +3,14 @@
 #include <random>
 #include <algorithm>
 #include <vector>
+#include <atomic>
+#include <thread>
 #include "src/smart_pointers.h"
 
 using task::UniquePtr;
 using task::SharedPtr;
 using task::WeakPtr;
+using task::MultiThreaded;
 
 
 size_t RandomUInt(size_t max = -1) {
@@ -40,6 +43,15 @@ struct Node {
     ~Node() {}
 };
 
+// подсчет живых объектов для проверки, что каждый объект удален ровно один раз
+std::atomic<long> alive{0};
+
+struct Tracked {
+    int value;
+    Tracked(int value): value(value) { ++alive; }
+    ~Tracked() { --alive; }
+};
+
 SharedPtr<Node> getCyclePtr(int cycleSize) {
     SharedPtr<Node> head(new Node(0));
     SharedPtr<Node> prev(head);
@@ -193,4 +205,50 @@ int main() {
         }
     }
 
+    {
+        // атомарные счетчики: копирование и lock из нескольких потоков
+        const int THREADS = 4;
+        const int ITERATIONS = 100'000;
+        {
+            SharedPtr<Tracked, MultiThreaded> shared(new Tracked(7));
+            WeakPtr<Tracked, MultiThreaded> weak(shared);
+            std::vector<std::thread> threads;
+            for (int t = 0; t < THREADS; ++t) {
+                threads.emplace_back([&shared, &weak] {
+                    for (int i = 0; i < ITERATIONS; ++i) {
+                        SharedPtr<Tracked, MultiThreaded> copy(shared);
+                        SharedPtr<Tracked, MultiThreaded> locked = weak.lock();
+                        WeakPtr<Tracked, MultiThreaded> weak_copy(copy);
+                        ASSERT_TRUE(locked.get() == copy.get() && locked->value == 7);
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            ASSERT_TRUE_MSG(shared.use_count() == 1, "MultiThreaded: use_count after concurrent copies")
+        }
+        ASSERT_TRUE_MSG(alive == 0, "MultiThreaded: object is deleted")
+
+        // lock одновременно с удалением последнего SharedPtr: либо пустой указатель, либо живой объект
+        for (int i = 0; i < 2'000; ++i) {
+            auto shared = SharedPtr<Tracked, MultiThreaded>(new Tracked(i));
+            WeakPtr<Tracked, MultiThreaded> weak(shared);
+            std::atomic<bool> start{false};
+            std::thread locker([&] {
+                while (!start) {
+                }
+                for (int k = 0; k < 100; ++k) {
+                    SharedPtr<Tracked, MultiThreaded> locked = weak.lock();
+                    ASSERT_TRUE(locked.get() == nullptr || (locked->value == i && locked.use_count() >= 1));
+                }
+            });
+            start = true;
+            shared.reset();
+            locker.join();
+            ASSERT_TRUE_MSG(weak.expired(), "MultiThreaded: expired after the last reset")
+        }
+        ASSERT_TRUE_MSG(alive == 0, "MultiThreaded: lock does not resurrect deleted objects")
+    }
+
 }